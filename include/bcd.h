@@ -27,20 +27,57 @@
 // https://www.cs.cmu.edu/~motionplanning/lecture/Chap6-CellDecomp_howie.pdf
 namespace polygon_coverage_planning {
 
-std::vector<Polygon_2> computeBCD(const PolygonWithHoles& polygon_in, const Direction_2& dir);
-void sortPolygon(PolygonWithHoles* pwh);
-std::vector<VertexConstCirculator> getXSortedVertices(
-    const PolygonWithHoles& p);
-void processEvent(const PolygonWithHoles& pwh, const VertexConstCirculator& v,
-                std::vector<VertexConstCirculator>* sorted_vertices,
-                std::vector<Point_2>* processed_vertices,
-                std::list<Segment_2>* L, std::list<Polygon_2>* open_polygons,
-                std::vector<Polygon_2>* closed_polygons);
-std::vector<Point_2> getIntersections(const std::list<Segment_2>& L, const Line_2& l);
-bool outOfPWH(const PolygonWithHoles& pwh, const Point_2& p);
+// Compute the BCD sweeping along dir. If num_slabs > 1, the rotated polygon is
+// cut into vertical slabs at event free x-positions. The slabs are decomposed
+// on separate threads and cells crossing a cut are stitched back together.
+std::vector<Polygon_2> computeBCD(const PolygonWithHoles& polygon_in,
+                                  const Direction_2& dir,
+                                  size_t num_slabs = 1);
+// Compute the BCD of a polygon that is already rotated, sorted and simplified.
+// The sweep is instantiated for K and InexactKernel.
+template <class Kernel>
+std::vector<CGAL::Polygon_2<Kernel>> computeRotatedBCD(
+    const CGAL::Polygon_with_holes_2<Kernel>& rotated_polygon);
+// Same as computeRotatedBCD, but decompose num_slabs vertical slabs in
+// parallel.
+std::vector<Polygon_2> computeSlabBCD(const PolygonWithHoles& rotated_polygon,
+                                      size_t num_slabs);
+// Find x-positions that split the polygon into num_slabs slabs with a similar
+// number of events. No vertex lies on a cut.
+std::vector<FT> findSlabCuts(const PolygonWithHoles& pwh, size_t num_slabs);
+// Find the vertical edge of a cell that lies on the cut x. Returns the lower
+// y-coordinate of the edge.
+bool findCutEdge(const Polygon_2& cell, const FT& x, FT* y_low);
+// Merge two counter-clockwise cells that share the vertical edge on the cut x.
+// left is the cell on the lower x side.
+Polygon_2 stitchCells(const Polygon_2& left, const Polygon_2& right,
+                      const FT& x);
+template <class Kernel>
+void sortPolygon(CGAL::Polygon_with_holes_2<Kernel>* pwh);
+template <class Kernel>
+std::vector<typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator>
+getXSortedVertices(const CGAL::Polygon_with_holes_2<Kernel>& p);
+template <class Kernel>
+void processEvent(
+    const CGAL::Polygon_with_holes_2<Kernel>& pwh,
+    const typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator& v,
+    std::vector<typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator>*
+        sorted_vertices,
+    std::vector<typename Kernel::Point_2>* processed_vertices,
+    std::list<typename Kernel::Segment_2>* L,
+    std::list<CGAL::Polygon_2<Kernel>>* open_polygons,
+    std::vector<CGAL::Polygon_2<Kernel>>* closed_polygons);
+template <class Kernel>
+std::vector<typename Kernel::Point_2> getIntersections(
+    const std::list<typename Kernel::Segment_2>& L,
+    const typename Kernel::Line_2& l);
+template <class Kernel>
+bool outOfPWH(const CGAL::Polygon_with_holes_2<Kernel>& pwh,
+              const typename Kernel::Point_2& p);
 // Removes duplicate vertices. Returns if resulting polygon is simple and has
 // some area.
-bool cleanupPolygon(Polygon_2* poly);
+template <class Kernel>
+bool cleanupPolygon(CGAL::Polygon_2<Kernel>* poly);
 
 }  // namespace polygon_coverage_planning
 
@@ -0,0 +1,66 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_CELL_ADJACENCY_H_
+#define COVERAGEPLANNER_CELL_ADJACENCY_H_
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "cgal_definitions.h"
+#include "cost_model.h"
+#include "shortest_path_solver.h"
+
+namespace polygon_coverage_planning {
+
+// Find all cells that share a boundary segment of positive length. Edges are
+// grouped by their supporting line and overlapping edges of different cells
+// are found by sorting them along the line. O(n log n) in the total number of
+// edges.
+// neighbors: the adjacent cells of every cell in ascending order.
+void computeCellAdjacency(const std::vector<Polygon_2>& cells,
+                          std::vector<std::vector<size_t>>* neighbors);
+
+// The boundary segments two adjacent cells share. The key is the pair of cell
+// ids with first < second.
+typedef std::map<std::pair<size_t, size_t>, std::vector<Segment_2>>
+    SharedBoundaries;
+
+// Same as above, but also output the shared boundary segments, if
+// shared_boundaries is not null.
+void computeCellAdjacency(const std::vector<Polygon_2>& cells,
+                          std::vector<std::vector<size_t>>* neighbors,
+                          SharedBoundaries* shared_boundaries);
+
+// Distance between unreachable cells.
+const double kUnreachableCellDistance = 1e12;
+
+// Travel cost between all pairs of cells. Every cell is represented by the
+// end points of its sweep. The cost between two cells is the cheapest free
+// space path from an end point of one sweep to an end point of the other,
+// evaluated with cost_model. Cells without a sweep are unreachable.
+void computeCellDistances(const std::vector<std::vector<Point_2>>& cells_sweeps,
+                          const ShortestPathSolver& free_space_solver,
+                          const CostModel& cost_model,
+                          std::vector<std::vector<double>>* distances);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_CELL_ADJACENCY_H_
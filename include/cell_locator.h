@@ -0,0 +1,65 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_CELL_LOCATOR_H_
+#define COVERAGEPLANNER_CELL_LOCATOR_H_
+
+#include <vector>
+
+#include "cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// Point to cell lookup in a uniform grid over the cell bounding boxes. Every
+// grid bucket lists the cells whose bounding box overlaps it, the candidates
+// are tested exactly. With about one bucket per cell a query tests a constant
+// number of cells on average.
+class CellLocator {
+ public:
+  CellLocator(const std::vector<Polygon_2>& cells);
+
+  // Returns the lowest index of the cells containing p in their interior or on
+  // their boundary, -1 if there is none.
+  int locate(const Point_2& p) const;
+  // Same as locate, but if no cell contains p return the cell closest to p.
+  // Returns -1 only if there are no cells.
+  int locateNearest(const Point_2& p) const;
+
+  inline size_t size() const { return cells_.size(); }
+
+ private:
+  // The bucket coordinates overlapped by the box, clamped to the grid.
+  void getBucketRange(const CGAL::Bbox_2& box, int* col_min, int* col_max,
+                      int* row_min, int* row_max) const;
+  inline const std::vector<size_t>& getBucket(int col, int row) const {
+    return buckets_[row * cols_ + col];
+  }
+
+  std::vector<Polygon_2> cells_;
+  CGAL::Bbox_2 bbox_;
+  int cols_;
+  int rows_;
+  double bucket_width_;
+  double bucket_height_;
+  std::vector<std::vector<size_t>> buckets_;
+};
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_CELL_LOCATOR_H_
@@ -0,0 +1,45 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_CELL_MERGING_H_
+#define COVERAGEPLANNER_CELL_MERGING_H_
+
+#include <vector>
+
+#include "cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// Try to merge two cells. Succeeds if the union is a single polygon without
+// holes that is weakly monotone in at least one edge direction, i.e., that can
+// still be swept.
+bool mergeCellPair(const Polygon_2& a, const Polygon_2& b, Polygon_2* merged);
+
+// Merge the cells of a decomposition to save sweeps and transitions. First
+// every cell smaller than min_area or narrower than min_width is absorbed by
+// the adjacent cell it shares the longest boundary with. Then adjacent cells
+// are merged while their union can be swept and its smallest altitude does
+// not exceed the sum of theirs. Returns the number of merges, the adjacency of
+// the merged cells needs to be recomputed.
+size_t mergeCells(double min_area, double min_width,
+                  std::vector<Polygon_2>* cells);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_CELL_MERGING_H_
@@ -44,6 +44,9 @@ typedef Polygon_2::Edge_const_iterator EdgeConstIterator;
 typedef Polygon_2::Edge_const_circulator EdgeConstCirculator;
 typedef CGAL::Polygon_with_holes_2<K> PolygonWithHoles;
 typedef CGAL::Exact_predicates_inexact_constructions_kernel InexactKernel;
+typedef CGAL::Polygon_2<InexactKernel> InexactPolygon_2;
+typedef InexactPolygon_2::Vertex_const_circulator InexactVertexConstCirculator;
+typedef CGAL::Polygon_with_holes_2<InexactKernel> InexactPolygonWithHoles;
 
 
 #endif  // COVERAGEPLANNER_CGAL_DEFINITIONS_H_
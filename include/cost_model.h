@@ -0,0 +1,63 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_COST_MODEL_H_
+#define COVERAGEPLANNER_COST_MODEL_H_
+
+#include <vector>
+
+#include "cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// Estimates the execution time of a waypoint sequence. The robot drives
+// straight runs with a trapezoidal velocity profile, stopping at every
+// waypoint where the path changes direction, and turns in place there. The
+// default model reduces to the path length.
+class CostModel {
+ public:
+  CostModel();
+  // Non-positive acceleration or turn rate mean instantaneous acceleration or
+  // turning. turn_penalty is the extra time of every turn, e.g., to settle.
+  CostModel(double max_speed, double max_acceleration, double turn_rate,
+            double turn_penalty);
+
+  // Time to drive a straight run of the given length from rest to rest.
+  double computeRunTime(double length) const;
+  // Time to turn in place by angle radians, including the turn penalty.
+  double computeTurnTime(double angle) const;
+  // Time to follow the path. Collinear waypoints do not stop the robot,
+  // reversing is a turn by pi.
+  double computeCost(const std::vector<Point_2>& path) const;
+
+  inline double getMaxSpeed() const { return max_speed_; }
+  inline double getMaxAcceleration() const { return max_acceleration_; }
+  inline double getTurnRate() const { return turn_rate_; }
+  inline double getTurnPenalty() const { return turn_penalty_; }
+
+ private:
+  double max_speed_;
+  double max_acceleration_;
+  double turn_rate_;
+  double turn_penalty_;
+};
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_COST_MODEL_H_
@@ -6,8 +6,14 @@
 #define COVERAGEPLANNER_COVERAGE_PLANNER_H
 
 #include <vector>
+#include <array>
 #include <iostream>
 #include <math.h>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <random>
+#include <thread>
 
 #include "opencv2/core/core.hpp"
 #include "opencv2/highgui/highgui.hpp"
@@ -17,9 +23,17 @@
 #include <CGAL/Surface_sweep_2_algorithms.h>
 #include <CGAL/squared_distance_2.h>
 
+#include "cell_adjacency.h"
+#include "cell_locator.h"
+#include "cell_merging.h"
 #include "cgal_comm.h"
+#include "cost_model.h"
 #include "decomposition.h"
+#include "hole_filter.h"
+#include "parallel.h"
+#include "polygon_simplification.h"
 #include "sweep.h"
+#include "tsp.h"
 
 class MouseParams{
 public:
@@ -73,173 +87,626 @@ class CellNode
 public:
     CellNode()
     {
-        isVisited = false;
         isCleaned = false;
-        parentIndex = INT_MAX;
-        cellIndex = INT_MAX;
     }
-    bool isVisited;
     bool isCleaned;
+};
 
-    int parentIndex;
-    std::deque<int> neighbor_indices;
-
-    int cellIndex;
+// The cell graph in flat arrays: the neighbors of cell i are neighbors[offsets[i]] to
+// neighbors[offsets[i + 1] - 1].
+struct CellAdjacency
+{
+    std::vector<size_t> offsets;
+    std::vector<int> neighbors;
 };
 
-std::vector<CellNode> calculateDecompositionAdjacency(const std::vector<Polygon_2>& decompositions) {
+CellAdjacency calculateDecompositionAdjacency(const std::vector<std::vector<size_t>>& neighbors) {
 
-    std::vector<CellNode> polygon_adj_graph(decompositions.size());
-    for (size_t i = 0; i < decompositions.size() - 1; ++i) {
-        polygon_adj_graph[i].cellIndex = i;
-        for (size_t j = i + 1; j < decompositions.size(); ++j) {
-            PolygonWithHoles joined;
-            if (CGAL::join(decompositions[i], decompositions[j], joined)) {
-                polygon_adj_graph[i].neighbor_indices.emplace_back(j);
-                polygon_adj_graph[j].neighbor_indices.emplace_back(i);
-            }
-        }
+    CellAdjacency cell_adjacency;
+    cell_adjacency.offsets.assign(neighbors.size() + 1, 0);
+    for (size_t i = 0; i < neighbors.size(); ++i) {
+        cell_adjacency.neighbors.insert(cell_adjacency.neighbors.end(), neighbors[i].begin(), neighbors[i].end());
+        cell_adjacency.offsets[i + 1] = cell_adjacency.neighbors.size();
     }
-    polygon_adj_graph.back().cellIndex = decompositions.size()-1;
 
-    return polygon_adj_graph;
+    return cell_adjacency;
 }
 
-// DFS
-void walkThroughGraph(std::vector<CellNode>& cell_graph, int cell_index, int& unvisited_counter, std::deque<CellNode>& path)
+CellAdjacency calculateDecompositionAdjacency(const std::vector<Polygon_2>& decompositions) {
+
+    std::vector<std::vector<size_t>> neighbors;
+    polygon_coverage_planning::computeCellAdjacency(decompositions, &neighbors);
+    return calculateDecompositionAdjacency(neighbors);
+}
+
+// DFS that backtracks through visited cells until all cells are visited.
+// The parents form the stack and every cell keeps a cursor to its next neighbor to try, so the
+// traversal is iterative and each adjacency entry is scanned once.
+std::deque<int> getTravellingPath(const CellAdjacency& cell_adjacency, int first_cell_index)
 {
-    if(!cell_graph[cell_index].isVisited){
-        cell_graph[cell_index].isVisited = true;
-        unvisited_counter--;
+    std::deque<int> travelling_path;
+
+    const size_t num_cells = cell_adjacency.offsets.size() - 1;
+    if(num_cells==1){
+        travelling_path.emplace_back(0);
+        return travelling_path;
+    }
+    if(first_cell_index < 0 || first_cell_index >= static_cast<int>(num_cells)){
+        return travelling_path;
     }
-    path.emplace_front(cell_graph[cell_index]);
 
-//    for debugging
-//    std::cout<< "cell: " <<cell_graph[cell_index].cellIndex<<std::endl;
-//
+    const std::vector<size_t>& offsets = cell_adjacency.offsets;
+    const std::vector<int>& adjacency = cell_adjacency.neighbors;
+    std::vector<bool> visited(num_cells, false);
+    std::vector<int> parent(num_cells, -1);
+    std::vector<size_t> cursor(offsets.begin(), std::prev(offsets.end()));
+    size_t unvisited_counter = num_cells;
+
+    int cell_index = first_cell_index;
+    while(true){
+        if(!visited[cell_index]){
+            visited[cell_index] = true;
+            unvisited_counter--;
+        }
+        travelling_path.emplace_back(cell_index);
 
-    CellNode neighbor;
-    int neighbor_idx = INT_MAX;
+        // Neighbors only become visited, so the first unvisited one is never before the cursor.
+        while(cursor[cell_index] < offsets[cell_index + 1] && visited[adjacency[cursor[cell_index]]]){
+            cursor[cell_index]++;
+        }
 
-    for(int i = 0; i < cell_graph[cell_index].neighbor_indices.size(); i++){
-        neighbor = cell_graph[cell_graph[cell_index].neighbor_indices[i]];
-        neighbor_idx = cell_graph[cell_index].neighbor_indices[i];
-        if(!neighbor.isVisited){
+        // unvisited neighbor found
+        if(cursor[cell_index] < offsets[cell_index + 1]){
+            const int neighbor_idx = adjacency[cursor[cell_index]];
+            parent[neighbor_idx] = cell_index;
+            cell_index = neighbor_idx;
+        }
+        // cannot go on back-tracking
+        else if(parent[cell_index] == -1 || unvisited_counter == 0){
             break;
         }
+        else{
+            cell_index = parent[cell_index];
+        }
     }
 
-    // unvisited neighbor found
-    if(!neighbor.isVisited){
-        cell_graph[neighbor_idx].parentIndex = cell_graph[cell_index].cellIndex;
-        walkThroughGraph(cell_graph, neighbor_idx, unvisited_counter, path);
-    }
-    // unvisited neighbor not found
-    else{
-        // cannot go on back-tracking
-        if (cell_graph[cell_index].parentIndex == INT_MAX){
-            return;
-        }else if(unvisited_counter == 0){
-            return;
-        }else{
-            walkThroughGraph(cell_graph, cell_graph[cell_index].parentIndex, unvisited_counter, path);
+    return travelling_path;
+}
+
+// The cells of a travelling path in the order they are cleaned, i.e., without backtracking.
+std::vector<size_t> getCleaningOrder(const std::deque<int>& cell_idx_path, size_t num_cells){
+    std::vector<size_t> order;
+    std::vector<bool> seen(num_cells, false);
+    for(const int cell_idx : cell_idx_path){
+        if(!seen[cell_idx]){
+            seen[cell_idx] = true;
+            order.push_back(cell_idx);
         }
     }
+    return order;
 }
 
-std::deque<int> getTravellingPath(const std::vector<CellNode>& cell_graph, int first_cell_index)
-{
-    std::deque<int> travelling_path;
-
-    std::deque<CellNode> _cell_path;
-    std::vector<CellNode> _cell_graph = cell_graph;
+// The costs of a TSP cell order and of the DFS order it replaces.
+struct CellOrderCosts{
+    bool solved = false;
+    double tsp = 0.0;
+    double dfs = 0.0;
+};
 
-    if(_cell_graph.size()==1){
-        travelling_path.emplace_back(0);
-    }else{
-        int unvisited_counter = _cell_graph.size();
-        walkThroughGraph(_cell_graph, first_cell_index, unvisited_counter, _cell_path);
-        std::reverse(_cell_path.begin(), _cell_path.end());
+// Order the cells by solving the TSP over the travel costs between their sweeps, starting in the start cell
+// and optionally ending in end_cell_idx (-1 for a free end). costs receives the order cost next to the DFS
+// order cost, if not null. Returns the DFS path if the TSP cannot be solved.
+std::deque<int> getTspTravellingPath(const std::vector<std::vector<Point_2>>& cells_sweeps,
+                                     const polygon_coverage_planning::ShortestPathSolver& free_space_solver,
+                                     const polygon_coverage_planning::CostModel& cost_model,
+                                     const std::deque<int>& dfs_path, int start_cell_idx, int end_cell_idx,
+                                     double time_budget, CellOrderCosts* costs = nullptr){
+    polygon_coverage_planning::CostMatrix distances;
+    polygon_coverage_planning::computeCellDistances(cells_sweeps, free_space_solver, cost_model, &distances);
+
+    if(end_cell_idx == start_cell_idx && cells_sweeps.size() > 1){
+        end_cell_idx = -1;
+    }
+    std::vector<size_t> order;
+    if(!polygon_coverage_planning::solveTsp(distances, start_cell_idx, end_cell_idx, time_budget, &order)){
+        return dfs_path;
     }
 
-    for(auto& cell : _cell_path){
-        travelling_path.emplace_back(cell.cellIndex);
+    if(costs){
+        costs->solved = true;
+        costs->tsp = polygon_coverage_planning::computePathCost(distances, order);
+        costs->dfs = polygon_coverage_planning::computePathCost(distances,
+                                                                getCleaningOrder(dfs_path, cells_sweeps.size()));
     }
+    return std::deque<int>(order.begin(), order.end());
+}
 
-    return travelling_path;
+bool doReverseNextSweep(const Point_2& curr_point, const std::vector<Point_2>& next_sweep){
+    return CGAL::to_double(CGAL::squared_distance(curr_point, next_sweep.front())) > CGAL::to_double(CGAL::squared_distance(curr_point, next_sweep.back()));
+}
+
+std::vector<Point_2> getShortestPath(const polygon_coverage_planning::ShortestPathSolver& solver, const Point_2& start, const Point_2& goal){
+    std::vector<Point_2> shortest_path;
+    polygon_coverage_planning::calculateShortestPath(solver, start, goal, &shortest_path);
+    return shortest_path;
 }
 
-std::vector<std::map<int, std::list<Point_2 >>> calculateCellIntersections(std::vector<Polygon_2>& decompositions, std::vector<CellNode>& cell_graph){
+std::vector<Point_2> getShortestPath(const Polygon_2& polygon, const Point_2& start, const Point_2& goal){
+    std::unique_ptr<polygon_coverage_planning::ShortestPathSolver> solver =
+        polygon_coverage_planning::createShortestPathSolver(polygon);
+    return getShortestPath(*solver, start, goal);
+}
 
-    std::vector<std::map<int, std::list<Point_2 >>> cell_intersections(cell_graph.size());
+// A cell to sweep and the transition leading to it.
+struct CellVisit{
+    int cell_index;
+    bool reverse;   // Sweep the cell backwards.
+    Point_2 from;   // Exit of the previous sweep.
+    Point_2 entry;  // Entry of this sweep.
+};
 
-    for(size_t i = 0; i < cell_graph.size(); ++i){
-        for(size_t j = 0; j < cell_graph[i].neighbor_indices.size(); ++j){
-            std::list<Point_2> pts;
-            for(auto m = decompositions[i].edges_begin(); m != decompositions[i].edges_end(); ++m){
-                for(auto n = decompositions[cell_graph[i].neighbor_indices[j]].edges_begin();
-                    n != decompositions[cell_graph[i].neighbor_indices[j]].edges_end();
-                    ++n){
-                    Segment_2 segments[] = {*m, *n};
-                    CGAL::compute_intersection_points(segments, segments+2, std::back_inserter(pts));
-                }
+CellVisit makeCellVisit(const Point_2& from, int cell_idx, const std::vector<Point_2>& sweep){
+    CellVisit visit;
+    visit.cell_index = cell_idx;
+    visit.reverse = doReverseNextSweep(from, sweep);
+    visit.from = from;
+    visit.entry = visit.reverse ? sweep.back() : sweep.front();
+    return visit;
+}
+
+// Decide the sweep orientation of every uncleaned cell along the travelling path.
+// The transitions only depend on their endpoints and can be computed independently.
+std::vector<CellVisit> resolveCellVisits(const Point_2& start, const std::deque<int>& cell_idx_path,
+                                         std::vector<CellNode>& cell_graph,
+                                         const std::vector<std::vector<Point_2>>& cells_sweeps){
+    std::vector<CellVisit> visits;
+    Point_2 point = start;
+    for(const int cell_idx : cell_idx_path){
+        if(cell_graph[cell_idx].isCleaned || cells_sweeps[cell_idx].empty()){
+            continue;
+        }
+        const CellVisit visit = makeCellVisit(point, cell_idx, cells_sweeps[cell_idx]);
+        visits.push_back(visit);
+        cell_graph[cell_idx].isCleaned = true;
+        point = visit.reverse ? cells_sweeps[cell_idx].front() : cells_sweeps[cell_idx].back();
+    }
+    return visits;
+}
+
+// Append the transition to and the sweep of a cell.
+void appendCellVisit(const CellVisit& visit, std::vector<Point_2> transition,
+                     const std::vector<std::vector<Point_2>>& cells_sweeps, std::vector<Point_2>* way_points){
+    if(transition.size() < 2){
+        std::cerr << "Cannot connect to cell " << visit.cell_index << std::endl;
+        transition = {visit.from, visit.entry};
+    }
+    way_points->insert(way_points->end(),
+                       way_points->empty() ? transition.begin() : std::next(transition.begin()),
+                       std::prev(transition.end()));
+
+    const std::vector<Point_2>& sweep = cells_sweeps[visit.cell_index];
+    if(visit.reverse){
+        way_points->insert(way_points->end(), sweep.rbegin(), sweep.rend());
+    }else{
+        way_points->insert(way_points->end(), sweep.begin(), sweep.end());
+    }
+}
+
+// Receives the next part of the plan: the transition to and the sweep of a cell.
+typedef std::function<void(int cell_index, const std::vector<Point_2>& waypoints)> WaypointCallback;
+
+// Plan cell by cell along the travelling path and hand every finished part to callback right away.
+// Worker threads compute the sweeps of later cells ahead while earlier parts are emitted. The first
+// transition stays inside the start cell, so the first part does not wait for the free space solver.
+// Returns the complete plan. The directions are found automatically.
+std::vector<Point_2> streamCoveragePlan(const PolygonWithHoles& pwh, const std::vector<Polygon_2>& cells,
+                                        const std::deque<int>& cell_idx_path, const Point_2& start,
+                                        const FT& sweep_step,
+                                        polygon_coverage_planning::ShortestPathEngine engine,
+                                        std::vector<std::vector<Point_2>>* cells_sweeps,
+                                        const WaypointCallback& callback){
+    // Cells in the order they are cleaned.
+    const std::vector<size_t> order = getCleaningOrder(cell_idx_path, cells.size());
+
+    // Compute the sweeps ahead in cleaning order.
+    cells_sweeps->assign(cells.size(), std::vector<Point_2>());
+    std::vector<std::promise<void>> sweep_promises(order.size());
+    std::vector<std::future<void>> sweep_futures;
+    for(auto& promise : sweep_promises){
+        sweep_futures.push_back(promise.get_future());
+    }
+    polygon_coverage_planning::SweepDirCache<K> sweep_dir_cache;
+    polygon_coverage_planning::SweepCache sweep_cache;
+    const size_t num_sweep_threads = std::max<size_t>(1, polygon_coverage_planning::getNumThreads() - 1);
+    std::thread sweeper([&](){
+        polygon_coverage_planning::parallelFor(order.size(), [&](size_t k){
+            const int cell_idx = order[k];
+            try{
+                Direction_2 best_dir;
+                polygon_coverage_planning::findBestSweepDir(cells[cell_idx], &sweep_dir_cache, &best_dir);
+                polygon_coverage_planning::computeSweep(cells[cell_idx], sweep_step, best_dir, true,
+                                                        &sweep_cache, &(*cells_sweeps)[cell_idx]);
+            }catch(const std::exception& e){
+                std::cerr << "Error constructing sweep for polygon " << cell_idx << ": " << e.what() << std::endl;
+                (*cells_sweeps)[cell_idx].clear();
+            }
+            sweep_promises[k].set_value();
+        }, num_sweep_threads);
+    });
+    // Join the sweeper on every exit, also if the solver, the path planning or the callback throws.
+    // The sweeper does not wait for this thread, so the join always returns.
+    struct SweeperJoiner{
+        std::thread& thread;
+        ~SweeperJoiner(){
+            if(thread.joinable()){
+                thread.join();
             }
+        }
+    } sweeper_joiner{sweeper};
+    std::future<std::unique_ptr<polygon_coverage_planning::ShortestPathSolver>> free_space_solver =
+        std::async(std::launch::async, [&pwh, engine](){
+            return polygon_coverage_planning::createShortestPathSolver(pwh, engine);
+        });
+    std::unique_ptr<polygon_coverage_planning::ShortestPathSolver> solver;
+
+    std::vector<Point_2> way_points;
+    Point_2 point = start;
+    for(size_t k = 0; k < order.size(); k++){
+        const int cell_idx = order[k];
+        sweep_futures[k].wait();
+        if((*cells_sweeps)[cell_idx].empty()){
+            continue;
+        }
 
-            for(auto p = decompositions[i].vertices_begin(); p != decompositions[i].vertices_end(); ++p){
-                for(auto q = decompositions[cell_graph[i].neighbor_indices[j]].vertices_begin(); q != decompositions[cell_graph[i].neighbor_indices[j]].vertices_end(); ++q){
-                    if(CGAL::to_double(p->x())==CGAL::to_double(q->x()) && CGAL::to_double(p->y())==CGAL::to_double(q->y())){
-                        pts.insert(pts.end(), *p);
-                    }
-                }
+        const CellVisit visit = makeCellVisit(point, cell_idx, (*cells_sweeps)[cell_idx]);
+        std::vector<Point_2> transition;
+        if(way_points.empty() && polygon_coverage_planning::pointInPolygon(cells[cell_idx], point)){
+            transition = getShortestPath(cells[cell_idx], visit.from, visit.entry);
+        }else{
+            if(!solver){
+                solver = free_space_solver.get();
             }
+            transition = getShortestPath(*solver, visit.from, visit.entry);
+        }
 
-            auto verbose = std::unique(pts.begin(), pts.end());
-            pts.erase(verbose, pts.end());
-            cell_intersections[i].insert(std::make_pair(cell_graph[i].neighbor_indices[j], pts));
-            cell_intersections[cell_graph[i].neighbor_indices[j]].insert(std::make_pair(i, pts));
+        const size_t first_new = way_points.size();
+        appendCellVisit(visit, transition, *cells_sweeps, &way_points);
+        callback(cell_idx, std::vector<Point_2>(way_points.begin() + first_new, way_points.end()));
+        point = way_points.back();
+    }
+
+    if(free_space_solver.valid()){
+        free_space_solver.wait();
+    }
+    return way_points;
+}
+
+double getPathLength(const std::vector<Point_2>& path){
+    double length = 0.0;
+    for(size_t i = 1; i < path.size(); i++){
+        length += std::sqrt(CGAL::to_double(CGAL::squared_distance(path[i-1], path[i])));
+    }
+    return length;
+}
+
+// Sweep every cell in the sweepable direction with the smallest cost, e.g., path length plus a penalty per
+// turn. All cells and directions are swept in one parallel loop. A cell falls back to the direction of
+// smallest altitude if not all of its sweeps can be computed. Cells that cannot be swept at all keep an
+// empty sweep. Returns false if there are any.
+bool computeTunedSweeps(const std::vector<Polygon_2>& cells, const FT& sweep_step,
+                        const polygon_coverage_planning::CostModel& cost_model,
+                        std::vector<std::vector<Point_2>>* cells_sweeps){
+    std::vector<std::vector<std::vector<Point_2>>> all_sweeps;
+    polygon_coverage_planning::computeAllSweeps(cells, CGAL::to_double(sweep_step), &all_sweeps);
+
+    cells_sweeps->assign(cells.size(), std::vector<Point_2>());
+    std::vector<size_t> fallback;
+    for(size_t c = 0; c < cells.size(); c++){
+        // Reversed sweeps cost the same and are skipped.
+        double min_cost = DBL_MAX;
+        for(size_t i = 0; i < all_sweeps[c].size(); i += 2){
+            const double cost = cost_model.computeCost(all_sweeps[c][i]);
+            if(!all_sweeps[c][i].empty() && cost < min_cost){
+                min_cost = cost;
+                (*cells_sweeps)[c] = std::move(all_sweeps[c][i]);
+            }
+        }
+        if(min_cost == DBL_MAX){
+            fallback.push_back(c);
+        }
+    }
+
+    polygon_coverage_planning::parallelFor(fallback.size(), [&](size_t k){
+        const Polygon_2& cell = cells[fallback[k]];
+        Direction_2 best_dir;
+        if(polygon_coverage_planning::findBestSweepDir(cell, &best_dir) == std::numeric_limits<double>::max()){
+            return;
+        }
+        std::unique_ptr<polygon_coverage_planning::ShortestPathSolver> solver =
+            polygon_coverage_planning::createShortestPathSolver(cell);
+        if(!polygon_coverage_planning::computeSweep(cell, *solver, sweep_step, best_dir, true,
+                                                    &(*cells_sweeps)[fallback[k]])){
+            (*cells_sweeps)[fallback[k]].clear();
+        }
+    });
+
+    for(const auto& sweep : *cells_sweeps){
+        if(sweep.empty()){
+            return false;
         }
     }
+    return true;
+}
 
-    return cell_intersections;
+// Index of point in points, appended if missing.
+size_t findOrAddPoint(const Point_2& point, std::vector<Point_2>* points){
+    auto it = std::find(points->begin(), points->end(), point);
+    if(it != points->end()){
+        return it - points->begin();
+    }
+    points->push_back(point);
+    return points->size() - 1;
 }
 
-Point_2 findNextGoal(const Point_2& start, const Point_2& goal, const std::list<Point_2>& candidates){
-    double min_cost = DBL_MAX;
-    double cost;
-    Point_2 next_point = start;
-    Segment_2 seg_from_start, seg_to_goal;
-    for(auto point = candidates.begin(); point != candidates.end(); ++point){
-        seg_from_start = Segment_2(start, *point);
-        seg_to_goal = Segment_2(*point, goal);
-        cost = CGAL::to_double(seg_from_start.squared_length())+CGAL::to_double(seg_to_goal.squared_length());
-        if(cost < min_cost){
-            min_cost = cost;
-            next_point = *point;
+// Choose the sweep of every cell along the travelling path by dynamic programming such that the
+// summed sweep and transition costs are minimal. Candidates are all sweeps of computeAllSweeps and the
+// current sweep in both orientations, so the result never costs more than the greedy reversal.
+// The chosen sweeps replace cells_sweeps and are not reversed again.
+std::vector<CellVisit> selectSweepVariants(const Point_2& start, const std::deque<int>& cell_idx_path,
+                                           const std::vector<Polygon_2>& cells, const FT& sweep_step,
+                                           const polygon_coverage_planning::ShortestPathSolver& solver,
+                                           const polygon_coverage_planning::CostModel& cost_model,
+                                           std::vector<CellNode>& cell_graph,
+                                           std::vector<std::vector<Point_2>>* cells_sweeps){
+    std::vector<size_t> order;
+    for(const size_t cell_idx : getCleaningOrder(cell_idx_path, cells.size())){
+        if(!cell_graph[cell_idx].isCleaned && !(*cells_sweeps)[cell_idx].empty()){
+            order.push_back(cell_idx);
+        }
+    }
+    if(order.empty()){
+        return std::vector<CellVisit>();
+    }
+
+    // All sweep variants. The current sweep and its reverse come first. All cells and directions are swept
+    // in one parallel loop.
+    std::vector<Polygon_2> order_cells;
+    for(const size_t cell_idx : order){
+        order_cells.push_back(cells[cell_idx]);
+    }
+    std::vector<std::vector<std::vector<Point_2>>> all_sweeps;
+    polygon_coverage_planning::computeAllSweeps(order_cells, CGAL::to_double(sweep_step), &all_sweeps);
+    std::vector<std::vector<std::vector<Point_2>>> variants(order.size());
+    for(size_t k = 0; k < order.size(); k++){
+        const std::vector<Point_2>& sweep = (*cells_sweeps)[order[k]];
+        variants[k].push_back(sweep);
+        variants[k].emplace_back(sweep.rbegin(), sweep.rend());
+        for(auto& variant : all_sweeps[k]){
+            if(!variant.empty()){
+                variants[k].push_back(std::move(variant));
+            }
+        }
+    }
+
+    // Variants share their end points, transitions are only computed once per pair of end points.
+    std::vector<std::vector<Point_2>> end_points(order.size());
+    std::vector<std::vector<size_t>> entries(order.size()), exits(order.size());
+    std::vector<std::vector<double>> sweep_costs(order.size());
+    for(size_t k = 0; k < order.size(); k++){
+        for(const auto& variant : variants[k]){
+            entries[k].push_back(findOrAddPoint(variant.front(), &end_points[k]));
+            exits[k].push_back(findOrAddPoint(variant.back(), &end_points[k]));
+            sweep_costs[k].push_back(cost_model.computeCost(variant));
+        }
+    }
+
+    // transition_costs[k][i][j]: from end point i of the previous cell (or start) to end point j of cell k.
+    std::vector<std::vector<std::vector<double>>> transition_costs(order.size());
+    std::vector<std::array<size_t, 3>> queries;
+    for(size_t k = 0; k < order.size(); k++){
+        const size_t num_from = k == 0 ? 1 : end_points[k-1].size();
+        transition_costs[k].assign(num_from, std::vector<double>(end_points[k].size(), 0.0));
+        for(size_t i = 0; i < num_from; i++){
+            for(size_t j = 0; j < end_points[k].size(); j++){
+                queries.push_back({{k, i, j}});
+            }
+        }
+    }
+    polygon_coverage_planning::parallelFor(queries.size(), [&](size_t q){
+        const size_t k = queries[q][0], i = queries[q][1], j = queries[q][2];
+        const Point_2& from = k == 0 ? start : end_points[k-1][i];
+        const Point_2& to = end_points[k][j];
+        std::vector<Point_2> path = getShortestPath(solver, from, to);
+        if(path.size() < 2){
+            path = {from, to};  // Same fallback as appendCellVisit.
+        }
+        transition_costs[k][i][j] = cost_model.computeCost(path);
+    });
+
+    // cost[k][v]: shortest plan up to and including variant v of cell k.
+    std::vector<std::vector<double>> cost(order.size());
+    std::vector<std::vector<size_t>> predecessor(order.size());
+    for(size_t k = 0; k < order.size(); k++){
+        cost[k].assign(variants[k].size(), DBL_MAX);
+        predecessor[k].assign(variants[k].size(), 0);
+        for(size_t v = 0; v < variants[k].size(); v++){
+            if(k == 0){
+                cost[k][v] = transition_costs[k][0][entries[k][v]] + sweep_costs[k][v];
+                continue;
+            }
+            for(size_t u = 0; u < variants[k-1].size(); u++){
+                const double c = cost[k-1][u] + transition_costs[k][exits[k-1][u]][entries[k][v]] + sweep_costs[k][v];
+                if(c < cost[k][v]){
+                    cost[k][v] = c;
+                    predecessor[k][v] = u;
+                }
+            }
         }
     }
-    return next_point;
+
+    // Cost of reversing the current sweeps greedily for comparison.
+    double greedy_cost = 0.0;
+    Point_2 point = start;
+    size_t prev_exit = 0;
+    for(size_t k = 0; k < order.size(); k++){
+        const size_t v = doReverseNextSweep(point, variants[k][0]) ? 1 : 0;
+        greedy_cost += transition_costs[k][prev_exit][entries[k][v]] + sweep_costs[k][v];
+        prev_exit = exits[k][v];
+        point = variants[k][v].back();
+    }
+
+    std::vector<size_t> choice(order.size());
+    choice.back() = std::min_element(cost.back().begin(), cost.back().end()) - cost.back().begin();
+    for(size_t k = order.size() - 1; k > 0; k--){
+        choice[k-1] = predecessor[k][choice[k]];
+    }
+    std::cout << "Sweep variant plan cost: " << cost.back()[choice.back()]
+              << " (greedy: " << greedy_cost << ")" << std::endl;
+
+    std::vector<CellVisit> visits;
+    point = start;
+    for(size_t k = 0; k < order.size(); k++){
+        const int cell_idx = order[k];
+        (*cells_sweeps)[cell_idx] = std::move(variants[k][choice[k]]);
+        CellVisit visit;
+        visit.cell_index = cell_idx;
+        visit.reverse = false;
+        visit.from = point;
+        visit.entry = (*cells_sweeps)[cell_idx].front();
+        visits.push_back(visit);
+        cell_graph[cell_idx].isCleaned = true;
+        point = (*cells_sweeps)[cell_idx].back();
+    }
+    return visits;
 }
 
-bool doReverseNextSweep(const Point_2& curr_point, const std::vector<Point_2>& next_sweep){
-    return CGAL::to_double(CGAL::squared_distance(curr_point, next_sweep.front())) > CGAL::to_double(CGAL::squared_distance(curr_point, next_sweep.back()));
+// Plan the complete coverage of a decomposition with automatic sweep directions: sweep the cells, order
+// them and connect the sweeps through the free space. The sweeps are tuned and their variants selected as
+// in main, so a scored plan is the plan that runs. end is the optional fixed end of a TSP order.
+// order_costs receives the costs of the TSP order, if not null.
+std::vector<Point_2> planAutomaticCoverage(const std::vector<Polygon_2>& cells, const Point_2& start,
+                                           const FT& sweep_step,
+                                           const polygon_coverage_planning::ShortestPathSolver& free_space_solver,
+                                           const polygon_coverage_planning::CostModel& cost_model,
+                                           bool tune_sweeps, bool select_variants,
+                                           bool tsp_order, double tsp_time_budget, const Point_2* end = nullptr,
+                                           CellOrderCosts* order_costs = nullptr){
+    std::vector<std::vector<size_t>> neighbors;
+    polygon_coverage_planning::computeCellAdjacency(cells, &neighbors);
+    const CellAdjacency cell_adjacency = calculateDecompositionAdjacency(neighbors);
+    std::vector<CellNode> cell_graph(cells.size());
+
+    std::vector<std::vector<Point_2>> cells_sweeps(cells.size());
+    if(tune_sweeps){
+        computeTunedSweeps(cells, sweep_step, cost_model, &cells_sweeps);
+    }else{
+        polygon_coverage_planning::SweepDirCache<K> sweep_dir_cache;
+        polygon_coverage_planning::SweepCache sweep_cache;
+        polygon_coverage_planning::parallelFor(cells.size(), [&](size_t i){
+            Direction_2 best_dir;
+            polygon_coverage_planning::findBestSweepDir(cells[i], &sweep_dir_cache, &best_dir);
+            polygon_coverage_planning::computeSweep(cells[i], sweep_step, best_dir, true, &sweep_cache,
+                                                    &cells_sweeps[i]);
+        });
+    }
+
+    polygon_coverage_planning::CellLocator cell_locator(cells);
+    const int start_cell_idx = cell_locator.locateNearest(start);
+    std::deque<int> cell_idx_path = getTravellingPath(cell_adjacency, start_cell_idx);
+    if(tsp_order){
+        const int end_cell_idx = end ? cell_locator.locateNearest(*end) : -1;
+        cell_idx_path = getTspTravellingPath(cells_sweeps, free_space_solver, cost_model, cell_idx_path,
+                                             start_cell_idx, end_cell_idx, tsp_time_budget, order_costs);
+    }
+
+    const std::vector<CellVisit> visits =
+        select_variants ? selectSweepVariants(start, cell_idx_path, cells, sweep_step, free_space_solver,
+                                              cost_model, cell_graph, &cells_sweeps)
+                        : resolveCellVisits(start, cell_idx_path, cell_graph, cells_sweeps);
+    std::vector<std::vector<Point_2>> transitions(visits.size());
+    polygon_coverage_planning::parallelFor(visits.size(), [&](size_t k){
+        transitions[k] = getShortestPath(free_space_solver, visits[k].from, visits[k].entry);
+    });
+    std::vector<Point_2> way_points;
+    for(size_t k = 0; k < visits.size(); k++){
+        appendCellVisit(visits[k], transitions[k], cells_sweeps, &way_points);
+    }
+    return way_points;
 }
 
-std::vector<Point_2> getShortestPath(const Polygon_2& polygon, const Point_2& start, const Point_2& goal){
-    polygon_coverage_planning::visibility_graph::VisibilityGraph vis_graph(polygon);
-    std::vector<Point_2> shortest_path;
-    polygon_coverage_planning::calculateShortestPath(vis_graph, start, goal, &shortest_path);
-    return shortest_path;
+// Plan every candidate decomposition completely and return the index of the cheapest plan, -1 if there are
+// no candidates. The candidates are planned one after another, every plan runs its own loops in parallel.
+int selectDecompositionByPlan(const std::vector<std::vector<Polygon_2>>& candidates, const Point_2& start,
+                              const FT& sweep_step,
+                              const polygon_coverage_planning::ShortestPathSolver& free_space_solver,
+                              const polygon_coverage_planning::CostModel& cost_model,
+                              bool tune_sweeps, bool select_variants,
+                              bool tsp_order, double tsp_time_budget, const Point_2* end = nullptr){
+    std::vector<double> costs(candidates.size());
+    std::vector<CellOrderCosts> order_costs(candidates.size());
+    for(size_t i = 0; i < candidates.size(); i++){
+        costs[i] = cost_model.computeCost(planAutomaticCoverage(candidates[i], start, sweep_step, free_space_solver,
+                                                                cost_model, tune_sweeps, select_variants,
+                                                                tsp_order, tsp_time_budget, end, &order_costs[i]));
+    }
+
+    int best = -1;
+    for(size_t i = 0; i < candidates.size(); i++){
+        std::cout << "Decomposition candidate " << i << ": " << candidates[i].size() << " cells, plan cost "
+                  << costs[i];
+        if(order_costs[i].solved){
+            std::cout << ", TSP cell order cost " << order_costs[i].tsp << " (DFS: " << order_costs[i].dfs << ")";
+        }
+        std::cout << std::endl;
+        if(best < 0 || costs[i] < costs[best]){
+            best = i;
+        }
+    }
+    return best;
 }
 
-int getCellIndexOfPoint(const std::vector<Polygon_2>& decompositions, const Point_2& point){
-    int index = -1;
-    for(int i = 0; i < decompositions.size(); i++){
-        if(polygon_coverage_planning::pointInPolygon(decompositions[i], point)){
-            index = i;
-            break;
+// Compare build and query time of the shortest path engines on random queries in pwh.
+void benchmarkShortestPathEngines(const PolygonWithHoles& pwh, size_t num_queries){
+    const CGAL::Bbox_2 bbox = pwh.outer_boundary().bbox();
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> x_dist(bbox.xmin(), bbox.xmax());
+    std::uniform_real_distribution<double> y_dist(bbox.ymin(), bbox.ymax());
+    std::vector<Point_2> query_points;
+    while(query_points.size() < 2 * num_queries){
+        Point_2 p(x_dist(gen), y_dist(gen));
+        if(polygon_coverage_planning::pointInPolygon(pwh, p)){
+            query_points.push_back(p);
+        }
+    }
+
+    const polygon_coverage_planning::ShortestPathEngine engines[] = {
+        polygon_coverage_planning::ShortestPathEngine::kVisibilityGraph,
+        polygon_coverage_planning::ShortestPathEngine::kNavigationMesh};
+    std::cout << "Shortest path benchmark with " << num_queries << " queries:" << std::endl;
+    for(const auto& engine : engines){
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::unique_ptr<polygon_coverage_planning::ShortestPathSolver> solver =
+            polygon_coverage_planning::createShortestPathSolver(pwh, engine);
+        auto build_time = std::chrono::high_resolution_clock::now();
+
+        size_t num_failed = 0;
+        double length = 0.0;
+        std::vector<Point_2> path;
+        for(size_t i = 0; i < num_queries; i++){
+            if(solver->solve(query_points[2*i], query_points[2*i+1], &path)){
+                length += getPathLength(path);
+            } else {
+                num_failed++;
+            }
         }
+        auto end_time = std::chrono::high_resolution_clock::now();
+
+        std::cout << polygon_coverage_planning::getShortestPathEngineName(engine)
+                  << ": build " << std::chrono::duration<double>(build_time - start_time).count() << "s"
+                  << ", queries " << std::chrono::duration<double>(end_time - build_time).count() << "s"
+                  << ", total length " << length
+                  << ", failed " << num_failed << std::endl;
     }
-    return index;
 }
 
 #endif //COVERAGEPLANNER_COVERAGE_PLANNER_H
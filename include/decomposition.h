@@ -20,7 +20,9 @@
 #ifndef COVERAGEPLANNER_DECOMPOSITION_H_
 #define COVERAGEPLANNER_DECOMPOSITION_H_
 
+#include "cell_adjacency.h"
 #include "cgal_definitions.h"
+#include "shape_cache.h"
 
 namespace polygon_coverage_planning {
 
@@ -31,14 +33,55 @@ std::vector<Direction_2> findEdgeDirections(const PolygonWithHoles& pwh);
 // findEdgeDirections.
 std::vector<Direction_2> findPerpEdgeDirections(const PolygonWithHoles& pwh);
 
+// Get the directions perpendicular to all edges without opposite directions,
+// i.e., one direction per sweep line orientation, sorted by angle in
+// [0, 180) degrees.
+std::vector<Direction_2> findUniquePerpEdgeDirections(
+    const PolygonWithHoles& pwh);
+
 // Find the best edge direction to sweep. The best direction is the direction
 // with the smallest polygon altitude. Returns the smallest altitude.
-double findBestSweepDir(const Polygon_2& cell, Direction_2* best_dir = nullptr);
+// Instantiated for K and InexactKernel.
+template <class Kernel>
+double findBestSweepDir(const CGAL::Polygon_2<Kernel>& cell,
+                        CGAL::Direction_2<Kernel>* best_dir = nullptr);
+// Same as above, but reuse the result of a congruent cell from cache.
+template <class Kernel>
+double findBestSweepDir(const CGAL::Polygon_2<Kernel>& cell,
+                        SweepDirCache<Kernel>* cache,
+                        CGAL::Direction_2<Kernel>* best_dir = nullptr);
 
-// Compute BCDs for every edge direction. Return any with the smallest possible
-// altitude sum.
+// Number of best screened sweep directions that are verified with exact
+// arithmetic.
+const size_t kNumExactFinalists = 3;
+// Directions whose estimated altitude sum is within this relative tolerance of
+// the best estimate are verified as well.
+const double kFinalistTolerance = 0.01;
+
+// Select the directions to verify exactly from their estimated altitude sums:
+// all failed estimates, the kNumExactFinalists or num_candidates best
+// estimates, whichever are more, and all within kFinalistTolerance of the
+// best. Returns the direction ids in ascending order.
+std::vector<size_t> selectFinalists(const std::vector<double>& scores,
+                                    size_t num_candidates);
+
+// Compute BCDs for every edge direction. Every direction is screened with
+// double precision, the best candidates are decomposed with exact arithmetic.
+// Return any with the smallest exact altitude sum.
 bool computeBestBCDFromPolygonWithHoles(const PolygonWithHoles& pwh,
                                         std::vector<Polygon_2>* bcd_polygons);
+// Compute the BCDs of the num_candidates directions with the smallest altitude
+// sums, sorted by ascending exact altitude sum. Lets callers score the
+// candidates by the cost of the complete plan.
+bool computeBCDCandidates(const PolygonWithHoles& pwh, size_t num_candidates,
+                          std::vector<std::vector<Polygon_2>>* candidates);
+// Same as above, but also output the adjacent cells of every cell in ascending
+// order and the boundary segments adjacent cells share. shared_boundaries may
+// be null.
+bool computeBestBCDFromPolygonWithHoles(
+    const PolygonWithHoles& pwh, std::vector<Polygon_2>* bcd_polygons,
+    std::vector<std::vector<size_t>>* neighbors,
+    SharedBoundaries* shared_boundaries);
 
 // Compute TCDs for every edge direction. Return any with the smallest possible
 // altitude sum.
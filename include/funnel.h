@@ -0,0 +1,73 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_FUNNEL_H_
+#define COVERAGEPLANNER_FUNNEL_H_
+
+#include <mutex>
+#include <utility>
+
+#include "shortest_path_solver.h"
+#include "triangulation.h"
+
+namespace polygon_coverage_planning {
+
+// A portal is the edge between two consecutive triangles of a channel as
+// (left, right) point seen in travel direction.
+typedef std::pair<Point_2, Point_2> Portal;
+
+// Compute the shortest path through a channel of triangles with the funnel
+// algorithm. The first portal is (start, start), the last (goal, goal).
+// Lee, D. T., & Preparata, F. P. (1984). Euclidean shortest paths in the
+// presence of rectilinear barriers. Networks, 14(3), 393-410.
+void pullString(const std::vector<Portal>& portals,
+                std::vector<Point_2>* waypoints);
+
+// Shortest paths in a simple polygon. The polygon is triangulated once. The
+// dual graph of the triangulation is a tree, so every query only needs to walk
+// up the tree from start and goal triangle to their common ancestor and pull
+// the string through the resulting channel.
+class FunnelSolver : public ShortestPathSolver {
+ public:
+  FunnelSolver(const Polygon_2& polygon);
+
+  // If start or goal are outside the polygon, they are snapped (projected) back
+  // into it.
+  virtual bool solve(const Point_2& start, const Point_2& goal,
+                     std::vector<Point_2>* waypoints) const override;
+
+ private:
+  // Root the dual tree and compute parents and depths.
+  void buildTree();
+  // The triangles from start to goal face.
+  std::vector<FaceHandle> findChannel(const FaceHandle& start,
+                                      const FaceHandle& goal) const;
+
+  PolygonWithHoles polygon_;
+  CDT cdt_;
+  // Point location remembers its walk and is not thread safe.
+  mutable std::mutex locate_mutex_;
+  std::vector<FaceHandle> faces_;
+  std::vector<int> parent_;
+  std::vector<size_t> depth_;
+};
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_FUNNEL_H_
@@ -0,0 +1,44 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_HOLE_FILTER_H_
+#define COVERAGEPLANNER_HOLE_FILTER_H_
+
+#include <vector>
+
+#include "cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// Check whether the boundaries or the interiors of two polygons overlap.
+bool polygonsIntersect(const Polygon_2& a, const Polygon_2& b);
+
+// Reduce the holes of a free space before the decomposition, since every hole
+// adds events and cells. Holes smaller than min_area are removed. Holes
+// smaller than max_cluster_area with gaps narrower than cluster_distance are
+// replaced by the clockwise convex hull of their cluster, unless the hull
+// leaves the outer boundary or touches another hole. Collinear vertices are
+// removed from all holes. Returns the reduction in the number of holes.
+size_t filterHoles(const Polygon_2& outer, double min_area,
+                   double max_cluster_area, double cluster_distance,
+                   std::vector<Polygon_2>* holes);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_HOLE_FILTER_H_
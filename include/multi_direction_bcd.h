@@ -0,0 +1,63 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_MULTI_DIRECTION_BCD_H_
+#define COVERAGEPLANNER_MULTI_DIRECTION_BCD_H_
+
+#include "cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// Evaluates the BCD of one polygon for many sweep directions. The polygon is
+// sorted and simplified once for all directions. The BCD only depends on the
+// sweep line, so opposite directions are evaluated once. Every direction is
+// still a complete sweep, nothing is updated incrementally between directions.
+class MultiDirectionBCD {
+ public:
+  MultiDirectionBCD(const PolygonWithHoles& pwh);
+
+  // The unique sweep directions in [0, 180) degrees, sorted by angle.
+  inline const std::vector<Direction_2>& getDirections() const {
+    return directions_;
+  }
+
+  // Decompose along the directions [begin, end) and return the smallest cell
+  // altitude sum. The corresponding cells and direction are returned in
+  // best_cells and best_dir. If num_slabs > 1, every decomposition is split
+  // into parallel slabs.
+  double evaluate(size_t begin, size_t end, size_t num_slabs,
+                  std::vector<Polygon_2>* best_cells,
+                  Direction_2* best_dir = nullptr) const;
+
+  // Estimate the altitude sums of the directions [begin, end) with double
+  // precision and write them to (*scores)[i]. A negative score marks a
+  // direction whose estimate failed.
+  void estimate(size_t begin, size_t end, std::vector<double>* scores) const;
+
+ private:
+  // Sorted and simplified input polygon.
+  PolygonWithHoles polygon_;
+  // The same polygon with double coordinates.
+  InexactPolygonWithHoles inexact_polygon_;
+  std::vector<Direction_2> directions_;
+};
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_MULTI_DIRECTION_BCD_H_
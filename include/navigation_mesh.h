@@ -0,0 +1,95 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_NAVIGATION_MESH_H_
+#define COVERAGEPLANNER_NAVIGATION_MESH_H_
+
+#include <mutex>
+
+#include "graph_base.h"
+
+#include "cgal_definitions.h"
+#include "funnel.h"
+#include "shortest_path_solver.h"
+#include "triangulation.h"
+
+namespace polygon_coverage_planning {
+namespace navigation_mesh {
+
+struct NodeProperty {
+  NodeProperty() : center(Point_2(CGAL::ORIGIN)) {}
+  NodeProperty(const FaceHandle& face, const Point_2& center)
+      : face(face), center(center) {}
+  FaceHandle face;  // The triangle.
+  Point_2 center;   // The triangle centroid.
+};
+
+struct EdgeProperty {
+  EdgeProperty() {}
+  EdgeProperty(const Portal& portal) : portal(portal) {}
+  Portal portal;  // The shared triangle edge seen in edge direction.
+};
+
+// Shortest path calculation on a constrained Delaunay triangulation of the free
+// space. A* finds a channel of triangles which is then shortened with the
+// funnel algorithm. The graph has O(n) edges and queries need no visibility
+// computation, but the channel is the shortest between triangle centroids, so
+// the path is not necessarily globally optimal.
+// http://digestingduck.blogspot.com/2010/03/simple-stupid-funnel-algorithm.html
+class NavigationMesh : public GraphBase<NodeProperty, EdgeProperty>,
+                       public ShortestPathSolver {
+ public:
+  // Creates an undirected, weighted triangle graph.
+  NavigationMesh(const PolygonWithHoles& polygon);
+  NavigationMesh(const Polygon_2& polygon)
+      : NavigationMesh(PolygonWithHoles(polygon)) {}
+
+  // The nodes refer to faces of the owned triangulation.
+  NavigationMesh(const NavigationMesh&) = delete;
+  NavigationMesh& operator=(const NavigationMesh&) = delete;
+
+  virtual bool create() override;
+
+  // Compute the shortest path in a polygon with holes using A* on the
+  // triangles and the funnel algorithm.
+  // If start or goal are outside the polygon, they are snapped (projected) back
+  // into it.
+  virtual bool solve(const Point_2& start, const Point_2& goal,
+                     std::vector<Point_2>* waypoints) const override;
+
+  inline PolygonWithHoles getPolygon() const { return polygon_; }
+
+ private:
+  // Adds edges to all previously added adjacent triangles.
+  virtual bool addEdges() override;
+
+  // Calculate the Euclidean distance to goal for all given nodes.
+  virtual bool calculateHeuristic(size_t goal,
+                                  Heuristic* heuristic) const override;
+
+  PolygonWithHoles polygon_;
+  CDT cdt_;
+  // Point location remembers its walk and is not thread safe.
+  mutable std::mutex locate_mutex_;
+};
+
+}  // namespace navigation_mesh
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_NAVIGATION_MESH_H_
@@ -0,0 +1,62 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_PARALLEL_H_
+#define COVERAGEPLANNER_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace polygon_coverage_planning {
+
+// Number of hardware threads, at least one.
+inline size_t getNumThreads() {
+  const size_t num_threads = std::thread::hardware_concurrency();
+  return num_threads == 0 ? 1 : num_threads;
+}
+
+// Calls f(i) for every i in [0, n) using up to max_threads threads. Indices
+// are handed out one at a time, so unevenly sized work items still balance.
+// The calling thread takes part in the work.
+template <class Function>
+void parallelFor(size_t n, const Function& f,
+                 size_t max_threads = getNumThreads()) {
+  const size_t num_threads = std::min(n, max_threads);
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < n; ++i) f(i);
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < n; i = next++) f(i);
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i) threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads) thread.join();
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_PARALLEL_H_
@@ -0,0 +1,48 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_POLYGON_SIMPLIFICATION_H_
+#define COVERAGEPLANNER_POLYGON_SIMPLIFICATION_H_
+
+#include <vector>
+
+#include "cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// Simplify the rings of a free space, i.e., its outer boundary and holes,
+// together. Vertices are removed in order of the deviation from the original
+// outline their removal causes, while the deviation is at most tolerance or
+// the total number of vertices exceeds max_vertices (0 for no budget). A
+// removal is rejected if the shortcut touches any other edge or encloses a
+// vertex, so the rings stay simple, disjoint and nested as before. Every ring
+// keeps at least three vertices. Returns the number of removed vertices.
+size_t simplifyRings(double tolerance, size_t max_vertices,
+                     std::vector<Polygon_2>* rings);
+
+// Snap the edges within max_angle radians of dir or its perpendicular onto
+// lines in these directions through the edge midpoints. A ring is left
+// unchanged if a vertex would move farther than max_shift or the ring would
+// touch itself or another ring. Returns the number of snapped rings.
+size_t snapRingsToDirection(const Direction_2& dir, double max_angle,
+                            double max_shift, std::vector<Polygon_2>* rings);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_POLYGON_SIMPLIFICATION_H_
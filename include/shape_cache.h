@@ -0,0 +1,99 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_SHAPE_CACHE_H_
+#define COVERAGEPLANNER_SHAPE_CACHE_H_
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// Resolution of the coordinates that are hashed to find congruent shapes.
+const double kShapeHashResolution = 1.0e-6;
+
+// A translation invariant form of a polygon. The vertices are stored relative
+// to the lexicographically smallest vertex, starting with that vertex.
+// Polygons are only equal if they have the same orientation.
+template <class Kernel>
+class CanonicalShape {
+ public:
+  explicit CanonicalShape(const CGAL::Polygon_2<Kernel>& polygon);
+
+  // The position of the smallest vertex.
+  inline const CGAL::Vector_2<Kernel>& getOrigin() const { return origin_; }
+  inline size_t getHash() const { return hash_; }
+
+  // Exact coordinates have to match exactly. Inexact coordinates only have to
+  // match up to kShapeHashResolution.
+  bool operator==(const CanonicalShape& other) const;
+
+ private:
+  CGAL::Vector_2<Kernel> origin_;
+  std::vector<CGAL::Vector_2<Kernel>> relative_vertices_;
+  // The relative coordinates rounded to kShapeHashResolution.
+  std::vector<long long> key_;
+  size_t hash_;
+};
+
+// A thread safe cache of values that depend only on the shape of a polygon
+// and not on its position, e.g., the best sweep direction of a cell.
+template <class Kernel, class Value>
+class ShapeCache {
+ public:
+  ShapeCache() : num_hits_(0) {}
+
+  // Look up the value of a congruent shape.
+  bool find(const CanonicalShape<Kernel>& shape, Value* value) const;
+  // Store the value of shape. Keeps an existing value.
+  void insert(const CanonicalShape<Kernel>& shape, const Value& value);
+
+  size_t size() const;
+  size_t getNumHits() const;
+
+ private:
+  struct Hash {
+    size_t operator()(const CanonicalShape<Kernel>& shape) const {
+      return shape.getHash();
+    }
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<CanonicalShape<Kernel>, Value, Hash> cache_;
+  mutable size_t num_hits_;
+};
+
+// The best sweep direction of a cell and its altitude.
+template <class Kernel>
+struct BestSweepDir {
+  double altitude;
+  CGAL::Direction_2<Kernel> dir;
+};
+
+template <class Kernel>
+using SweepDirCache = ShapeCache<Kernel, BestSweepDir<Kernel>>;
+
+}  // namespace polygon_coverage_planning
+
+#include "shape_cache_impl.h"
+
+#endif  // COVERAGEPLANNER_SHAPE_CACHE_H_
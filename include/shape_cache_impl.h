@@ -0,0 +1,98 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_SHAPE_CACHE_IMPL_H_
+#define COVERAGEPLANNER_SHAPE_CACHE_IMPL_H_
+
+#include <cmath>
+#include <type_traits>
+
+#include <boost/functional/hash.hpp>
+
+namespace polygon_coverage_planning {
+
+template <class Kernel>
+CanonicalShape<Kernel>::CanonicalShape(const CGAL::Polygon_2<Kernel>& polygon)
+    : hash_(polygon.size()) {
+  if (polygon.is_empty()) return;
+
+  // Start at the smallest vertex.
+  typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator start =
+      polygon.vertices_circulator();
+  typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator vc = start;
+  do {
+    if (CGAL::compare_xy(*vc, *start) == CGAL::SMALLER) start = vc;
+  } while (++vc != polygon.vertices_circulator());
+  origin_ = *start - CGAL::ORIGIN;
+
+  relative_vertices_.reserve(polygon.size());
+  key_.reserve(2 * polygon.size());
+  vc = start;
+  do {
+    relative_vertices_.push_back(*vc - *start);
+    for (const double c : {CGAL::to_double(relative_vertices_.back().x()),
+                           CGAL::to_double(relative_vertices_.back().y())}) {
+      key_.push_back(std::llround(c / kShapeHashResolution));
+      boost::hash_combine(hash_, key_.back());
+    }
+  } while (++vc != start);
+}
+
+template <class Kernel>
+bool CanonicalShape<Kernel>::operator==(const CanonicalShape& other) const {
+  if (hash_ != other.hash_ || key_ != other.key_) return false;
+  // Two exact shapes may still differ below the hash resolution.
+  return !std::is_same<Kernel, K>::value ||
+         relative_vertices_ == other.relative_vertices_;
+}
+
+template <class Kernel, class Value>
+bool ShapeCache<Kernel, Value>::find(const CanonicalShape<Kernel>& shape,
+                                     Value* value) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  typename std::unordered_map<CanonicalShape<Kernel>, Value,
+                              Hash>::const_iterator it = cache_.find(shape);
+  if (it == cache_.end()) return false;
+  *value = it->second;
+  ++num_hits_;
+  return true;
+}
+
+template <class Kernel, class Value>
+void ShapeCache<Kernel, Value>::insert(const CanonicalShape<Kernel>& shape,
+                                       const Value& value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.insert(std::make_pair(shape, value));
+}
+
+template <class Kernel, class Value>
+size_t ShapeCache<Kernel, Value>::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.size();
+}
+
+template <class Kernel, class Value>
+size_t ShapeCache<Kernel, Value>::getNumHits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_hits_;
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_SHAPE_CACHE_IMPL_H_
@@ -0,0 +1,89 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_SHORTEST_PATH_SOLVER_H_
+#define COVERAGEPLANNER_SHORTEST_PATH_SOLVER_H_
+
+#include <memory>
+#include <string>
+
+#include "cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+// Interface to compute shortest paths inside a fixed polygon.
+class ShortestPathSolver {
+ public:
+  virtual ~ShortestPathSolver() {}
+
+  // Compute the shortest path from start to goal. The waypoints contain start
+  // and goal. If start or goal are outside the polygon, they are snapped
+  // (projected) back into it. Safe to call from several threads.
+  virtual bool solve(const Point_2& start, const Point_2& goal,
+                     std::vector<Point_2>* waypoints) const = 0;
+};
+
+// The shortest path in a convex polygon is the straight segment.
+class StraightLineSolver : public ShortestPathSolver {
+ public:
+  StraightLineSolver(const Polygon_2& polygon) : polygon_(polygon) {}
+
+  virtual bool solve(const Point_2& start, const Point_2& goal,
+                     std::vector<Point_2>* waypoints) const override;
+
+ private:
+  PolygonWithHoles polygon_;
+};
+
+// Engines for polygons with holes.
+enum ShortestPathEngine {
+  kVisibilityGraph = 0,  // Exact, O(n^2) edges.
+  kNavigationMesh        // Triangle graph, O(n) edges.
+};
+
+inline bool checkShortestPathEngineValid(const int engine) {
+  return (engine == ShortestPathEngine::kVisibilityGraph) ||
+         (engine == ShortestPathEngine::kNavigationMesh);
+}
+
+inline std::string getShortestPathEngineName(const ShortestPathEngine& engine) {
+  switch (engine) {
+    case ShortestPathEngine::kVisibilityGraph:
+      return "Visibility Graph";
+    case ShortestPathEngine::kNavigationMesh:
+      return "Navigation Mesh";
+    default:
+      return "Unknown!";
+  }
+}
+
+// Create the cheapest solver for the polygon: a straight line in convex
+// polygons, the funnel algorithm in simple polygons and the given engine in
+// polygons with holes.
+std::unique_ptr<ShortestPathSolver> createShortestPathSolver(
+    const PolygonWithHoles& polygon,
+    ShortestPathEngine engine = ShortestPathEngine::kVisibilityGraph);
+inline std::unique_ptr<ShortestPathSolver> createShortestPathSolver(
+    const Polygon_2& polygon) {
+  return createShortestPathSolver(PolygonWithHoles(polygon));
+}
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_SHORTEST_PATH_SOLVER_H_
@@ -21,26 +21,56 @@
 #define COVERAGEPLANNER_SWEEP_H_
 
 #include "cgal_definitions.h"
+#include "shape_cache.h"
+#include "shortest_path_solver.h"
 #include "visibility_graph.h"
 
 namespace polygon_coverage_planning {
 
 // Compute the sweep by moving from the bottom to the top of the polygon.
 bool computeSweep(const Polygon_2& in,
-                  const visibility_graph::VisibilityGraph& visibility_graph,
+                  const ShortestPathSolver& shortest_path_solver,
                   const FT offset, const Direction_2& dir,
                   bool counter_clockwise, std::vector<Point_2>* waypoints);
 
+// A sweep relative to the origin of the canonical shape of its polygon.
+struct CachedSweep {
+  Direction_2 dir;
+  bool counter_clockwise;
+  std::vector<Vector_2> waypoints;
+};
+typedef ShapeCache<K, CachedSweep> SweepCache;
+
+// Same as computeSweep, but reuse the sweep of a congruent polygon from
+// sweep_cache. The shortest path solver is only built if the cache misses. All
+// sweeps in one cache need to use the same offset.
+bool computeSweep(const Polygon_2& in, const FT offset, const Direction_2& dir,
+                  bool counter_clockwise, SweepCache* sweep_cache,
+                  std::vector<Point_2>* waypoints);
+
 // Compute sweeps in all sweepable directions, starting counter-clockwise,
 // clockwise, and reverse.
 bool computeAllSweeps(const Polygon_2& poly, const double max_sweep_offset,
                       std::vector<std::vector<Point_2>>* cluster_sweeps);
+// Same as above for many polygons. All polygons, directions and orientations
+// are swept in one parallel loop. The sweeps of a polygon are empty if any of
+// them fails. Returns false if any polygon fails.
+bool computeAllSweeps(
+    const std::vector<Polygon_2>& polys, const double max_sweep_offset,
+    std::vector<std::vector<std::vector<Point_2>>>* cluster_sweeps);
 
 // A segment is observable if all vertices between two sweeps are observable.
 void checkObservability(
     const Segment_2& prev_sweep, const Segment_2& sweep,
     const std::vector<Point_2>& sorted_pts, const FT max_sq_distance,
     std::vector<Point_2>::const_iterator* lowest_unobservable_point);
+// Same as above, but resume the search at *first_point and advance it past the
+// points below prev_sweep. Consecutive calls need prev_sweep to move up.
+void checkObservability(
+    const Segment_2& prev_sweep, const Segment_2& sweep,
+    const std::vector<Point_2>& sorted_pts, const FT max_sq_distance,
+    std::vector<Point_2>::const_iterator* first_point,
+    std::vector<Point_2>::const_iterator* lowest_unobservable_point);
 
 // Find the intersections between a polygon and a line and sort them by the
 // distance to the perpendicular direction of the line.
@@ -50,6 +80,47 @@ std::vector<Point_2> findIntersections(const Polygon_2& p, const Line_2& l);
 bool findSweepSegment(const Polygon_2& p, const Line_2& l,
                       Segment_2* sweep_segment);
 
+// Finds the sweep segments of a polygon that is weakly monotone perpendicular
+// to the sweep direction by walking its two monotone chains from south to
+// north. Consecutive sweep lines only move the chain pointers, so a sweep
+// segment costs amortized O(1). Other polygons fall back to findSweepSegment.
+class SweepSegmentGenerator {
+ public:
+  SweepSegmentGenerator(const Polygon_2& polygon, const Direction_2& dir);
+
+  // Same as findSweepSegment. l has to point in the sweep direction.
+  bool getSweepSegment(const Line_2& l, Segment_2* sweep_segment);
+
+  // Shortest path between two boundary points of a monotone polygon that lie
+  // on the same chain, e.g., the end of a sweep and the start of the next. The
+  // path is the taut string along the chain. Returns false if the polygon is
+  // not monotone, the points are on different chains or the string would
+  // touch the other chain.
+  bool findChainPath(const Point_2& start, const Point_2& goal,
+                     std::vector<Point_2>* path) const;
+
+ private:
+  // Move the chain pointer to the last vertex not above l and append the
+  // intersections of the chain with l.
+  void intersectChain(const Line_2& l, const std::vector<Point_2>& chain,
+                      size_t* id, std::vector<Point_2>* intersections) const;
+  // Find the chain edge (id, id + 1) that contains p.
+  bool locateOnChain(const std::vector<Point_2>& chain, const Point_2& p,
+                     size_t* id) const;
+  // Index of the first chain vertex not below p.
+  size_t lowerBound(const std::vector<Point_2>& chain, const Point_2& p) const;
+
+  const Polygon_2& polygon_;
+  // Line along the sweep direction to compare heights.
+  Line_2 x_axis_;
+  bool is_monotone_;
+  // Both chains start at south and end at north.
+  std::vector<Point_2> left_chain_;
+  std::vector<Point_2> right_chain_;
+  size_t left_id_;
+  size_t right_id_;
+};
+
 // Sort vertices of polygon based on signed distance to line l.
 std::vector<Point_2> sortVerticesToLine(const Polygon_2& p, const Line_2& l);
 
@@ -58,6 +129,10 @@ bool calculateShortestPath(
     const visibility_graph::VisibilityGraph& visibility_graph,
     const Point_2& start, const Point_2& goal,
     std::vector<Point_2>* shortest_path);
+// Connect to points in the polygon using any shortest path solver.
+bool calculateShortestPath(const ShortestPathSolver& shortest_path_solver,
+                           const Point_2& start, const Point_2& goal,
+                           std::vector<Point_2>* shortest_path);
 
 }  // namespace polygon_coverage_planning
 
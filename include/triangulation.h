@@ -0,0 +1,65 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_TRIANGULATION_H_
+#define COVERAGEPLANNER_TRIANGULATION_H_
+
+#include <CGAL/Constrained_Delaunay_triangulation_2.h>
+#include <CGAL/Triangulation_face_base_with_info_2.h>
+
+#include "cgal_definitions.h"
+
+namespace polygon_coverage_planning {
+
+struct FaceInfo {
+  FaceInfo() : nesting_level(-1), id(-1) {}
+  // Even levels are outside the polygon, odd levels inside.
+  int nesting_level;
+  // Index of the face among the faces inside the polygon, -1 outside.
+  int id;
+
+  inline bool inDomain() const { return nesting_level % 2 == 1; }
+};
+
+typedef CGAL::Triangulation_vertex_base_2<K> Vb;
+typedef CGAL::Triangulation_face_base_with_info_2<FaceInfo, K> Fbb;
+typedef CGAL::Constrained_triangulation_face_base_2<K, Fbb> Fb;
+typedef CGAL::Triangulation_data_structure_2<Vb, Fb> Tds;
+typedef CGAL::Constrained_Delaunay_triangulation_2<K, Tds,
+                                                   CGAL::Exact_predicates_tag>
+    CDT;
+typedef CDT::Face_handle FaceHandle;
+
+// Triangulate the polygon with its boundary and holes as constraints. Marks
+// the faces inside the polygon and numbers them in *faces.
+void triangulatePolygon(const PolygonWithHoles& pwh, CDT* cdt,
+                        std::vector<FaceHandle>* faces);
+
+// Find a face inside the polygon that contains p, also if p lies on an edge or
+// vertex. Returns false if p is outside.
+bool locateFace(const CDT& cdt, const Point_2& p, FaceHandle* face);
+
+// The edge between face and its neighbor as seen when moving from face to the
+// neighbor.
+void getPortal(const FaceHandle& face, const FaceHandle& neighbor,
+               Point_2* left, Point_2* right);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_TRIANGULATION_H_
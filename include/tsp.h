@@ -0,0 +1,48 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COVERAGEPLANNER_TSP_H_
+#define COVERAGEPLANNER_TSP_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace polygon_coverage_planning {
+
+// Up to this many nodes the TSP is solved exactly with Held-Karp.
+const size_t kMaxExactTspSize = 13;
+
+// A symmetric cost matrix.
+typedef std::vector<std::vector<double>> CostMatrix;
+
+// Find the cheapest path that visits every node once. start and end fix the
+// first and last node, -1 leaves them free. Small instances are solved
+// exactly. Larger ones start from a nearest neighbor path that is improved
+// with 2-opt and Or-opt moves until no move improves or time_budget seconds
+// passed.
+// Returns false if the instance is invalid.
+bool solveTsp(const CostMatrix& cost, int start, int end, double time_budget,
+              std::vector<size_t>* path);
+
+// The summed cost of consecutive nodes in path.
+double computePathCost(const CostMatrix& cost, const std::vector<size_t>& path);
+
+}  // namespace polygon_coverage_planning
+
+#endif  // COVERAGEPLANNER_TSP_H_
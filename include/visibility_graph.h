@@ -25,6 +25,7 @@
 #include "graph_base.h"
 
 #include "cgal_definitions.h"
+#include "shortest_path_solver.h"
 
 namespace polygon_coverage_planning {
 namespace visibility_graph {
@@ -41,7 +42,8 @@ struct EdgeProperty {};
 
 // Shortest path calculation in the reduced visibility graph.
 // https://www.david-gouveia.com/pathfinding-on-a-2d-polygonal-map
-class VisibilityGraph : public GraphBase<NodeProperty, EdgeProperty> {
+class VisibilityGraph : public GraphBase<NodeProperty, EdgeProperty>,
+                        public ShortestPathSolver {
  public:
   // Creates an undirected, weighted visibility graph.
   VisibilityGraph(const PolygonWithHoles& polygon);
@@ -56,8 +58,8 @@ class VisibilityGraph : public GraphBase<NodeProperty, EdgeProperty> {
   // precomputed visibility graph.
   // If start or goal are outside the polygon, they are snapped (projected) back
   // into it.
-  bool solve(const Point_2& start, const Point_2& goal,
-             std::vector<Point_2>* waypoints) const;
+  virtual bool solve(const Point_2& start, const Point_2& goal,
+                     std::vector<Point_2>* waypoints) const override;
   // Same as solve but provide a precomputed visibility graph for the polygon.
   // Note: Start and goal need to be contained in the polygon_.
   bool solve(const Point_2& start, const Polygon_2& start_visibility_polygon,
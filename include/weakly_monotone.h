@@ -24,14 +24,39 @@
 
 namespace polygon_coverage_planning {
 
+// The functions are instantiated for K and InexactKernel.
+
 // Check whether polygon 'in' is weakly monotone perpendicular to 'x_axis'.
-bool isWeaklyMonotone(const Polygon_2& in, const Line_2& x_axis);
+template <class Kernel>
+bool isWeaklyMonotone(const CGAL::Polygon_2<Kernel>& in,
+                      const CGAL::Line_2<Kernel>& x_axis);
 // For all edges check whether polygon 'in' is weakly monotone perpendicular to
 // that edge.
-std::vector<Direction_2> getAllSweepableEdgeDirections(const Polygon_2& in);
+template <class Kernel>
+std::vector<CGAL::Direction_2<Kernel>> getAllSweepableEdgeDirections(
+    const CGAL::Polygon_2<Kernel>& in);
+// Same as above, but additionally return the polygon altitude perpendicular to
+// each direction. Runs in O(n log n): monotonicity follows from counting the
+// sign changes of the edge directions and the altitudes from rotating calipers
+// on the convex hull.
+template <class Kernel>
+void getAllSweepableEdgeDirections(
+    const CGAL::Polygon_2<Kernel>& in,
+    std::vector<CGAL::Direction_2<Kernel>>* dirs,
+    std::vector<double>* altitudes);
+
+// The distance between south and north perpendicular to dir.
+template <class Kernel>
+double computeAltitude(const CGAL::Point_2<Kernel>& south,
+                       const CGAL::Point_2<Kernel>& north,
+                       const CGAL::Direction_2<Kernel>& dir);
 
-VertexConstCirculator findSouth(const Polygon_2& in, const Line_2& x_axis);
-VertexConstCirculator findNorth(const Polygon_2& in, const Line_2& x_axis);
+template <class Kernel>
+typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator findSouth(
+    const CGAL::Polygon_2<Kernel>& in, const CGAL::Line_2<Kernel>& x_axis);
+template <class Kernel>
+typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator findNorth(
+    const CGAL::Polygon_2<Kernel>& in, const CGAL::Line_2<Kernel>& x_axis);
 
 }  // namespace polygon_coverage_planning
 
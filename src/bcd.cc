@@ -17,15 +17,19 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <map>
 #include <vector>
 
+#include <CGAL/Boolean_set_operations_2.h>
+
 #include "bcd.h"
 #include "cgal_comm.h"
+#include "parallel.h"
 
 namespace polygon_coverage_planning {
 
 std::vector<Polygon_2> computeBCD(const PolygonWithHoles &polygon_in,
-                                  const Direction_2 &dir) {
+                                  const Direction_2 &dir, size_t num_slabs) {
   // Rotate polygon to have direction aligned with x-axis.
   // TODO(rikba): Make this independent of rotation.
   PolygonWithHoles rotated_polygon = rotatePolygon(polygon_in, dir);
@@ -38,6 +42,27 @@ std::vector<Polygon_2> computeBCD(const PolygonWithHoles &polygon_in,
 
   simplifyPolygon(&rotated_polygon);
 
+  std::vector<Polygon_2> closed_polygons =
+      num_slabs > 1 ? computeSlabBCD(rotated_polygon, num_slabs)
+                    : computeRotatedBCD(rotated_polygon);
+
+  // Rotate back all polygons.
+  for (Polygon_2 &p : closed_polygons) {
+    CGAL::Aff_transformation_2<K> rotation(CGAL::ROTATION, dir, 1, 1e9);
+    p = CGAL::transform(rotation, p);
+  }
+
+  return closed_polygons;
+}
+
+template <class Kernel>
+std::vector<CGAL::Polygon_2<Kernel>>
+computeRotatedBCD(const CGAL::Polygon_with_holes_2<Kernel> &rotated_polygon) {
+  typedef typename Kernel::Point_2 Point_2;
+  typedef typename Kernel::Segment_2 Segment_2;
+  typedef CGAL::Polygon_2<Kernel> Polygon_2;
+  typedef typename Polygon_2::Vertex_const_circulator VertexConstCirculator;
+
   // std::cout << "Sorting vertices" << std::endl;
 
   // TODO: This is the bottleneck
@@ -65,19 +90,153 @@ std::vector<Polygon_2> computeBCD(const PolygonWithHoles &polygon_in,
                  &open_polygons, &closed_polygons);
   }
 
-  // Rotate back all polygons.
-  for (Polygon_2 &p : closed_polygons) {
-    CGAL::Aff_transformation_2<K> rotation(CGAL::ROTATION, dir, 1, 1e9);
-    p = CGAL::transform(rotation, p);
+  return closed_polygons;
+}
+
+std::vector<Polygon_2> computeSlabBCD(const PolygonWithHoles &rotated_polygon,
+                                      size_t num_slabs) {
+  std::vector<FT> cuts = findSlabCuts(rotated_polygon, num_slabs);
+  if (cuts.empty())
+    return computeRotatedBCD(rotated_polygon);
+
+  // Slab rectangles reach beyond the polygon in y and at the outer slabs.
+  CGAL::Bbox_2 bbox = rotated_polygon.outer_boundary().bbox();
+  const FT x_min(bbox.xmin() - 1.0), x_max(bbox.xmax() + 1.0);
+  const FT y_min(bbox.ymin() - 1.0), y_max(bbox.ymax() + 1.0);
+
+  // Decompose every slab on its own.
+  std::vector<std::vector<Polygon_2>> slab_cells(cuts.size() + 1);
+  parallelFor(slab_cells.size(), [&](size_t i) {
+    const FT &left = i == 0 ? x_min : cuts[i - 1];
+    const FT &right = i == cuts.size() ? x_max : cuts[i];
+    Polygon_2 slab;
+    slab.push_back(Point_2(left, y_min));
+    slab.push_back(Point_2(right, y_min));
+    slab.push_back(Point_2(right, y_max));
+    slab.push_back(Point_2(left, y_max));
+
+    std::vector<PolygonWithHoles> pieces;
+    CGAL::intersection(rotated_polygon, slab, std::back_inserter(pieces));
+    for (PolygonWithHoles &piece : pieces) {
+      sortPolygon(&piece);
+      simplifyPolygon(&piece);
+      std::vector<Polygon_2> cells = computeRotatedBCD(piece);
+      slab_cells[i].insert(slab_cells[i].end(), cells.begin(), cells.end());
+    }
+  }, num_slabs);
+
+  // Stitch cells from left to right. A cell crossing a cut touches it with
+  // exactly one vertical edge on either side, identified by its lower y.
+  std::vector<Polygon_2> closed_polygons;
+  std::map<FT, size_t> open_cells;
+  for (size_t i = 0; i < slab_cells.size(); ++i) {
+    std::map<FT, size_t> next_open_cells;
+    for (Polygon_2 &cell : slab_cells[i]) {
+      if (cell.is_clockwise_oriented())
+        cell.reverse_orientation();
+
+      size_t id = closed_polygons.size();
+      FT y_low;
+      std::map<FT, size_t>::iterator open_cell = open_cells.end();
+      if (i > 0 && findCutEdge(cell, cuts[i - 1], &y_low))
+        open_cell = open_cells.find(y_low);
+      if (open_cell != open_cells.end()) {
+        id = open_cell->second;
+        closed_polygons[id] =
+            stitchCells(closed_polygons[id], cell, cuts[i - 1]);
+        open_cells.erase(open_cell);
+      } else {
+        closed_polygons.push_back(cell);
+      }
+
+      if (i < cuts.size() && findCutEdge(closed_polygons[id], cuts[i], &y_low))
+        next_open_cells[y_low] = id;
+    }
+    open_cells.swap(next_open_cells);
   }
 
   return closed_polygons;
 }
 
+std::vector<FT> findSlabCuts(const PolygonWithHoles &pwh, size_t num_slabs) {
+  std::vector<FT> xs;
+  for (VertexConstIterator vit = pwh.outer_boundary().vertices_begin();
+       vit != pwh.outer_boundary().vertices_end(); ++vit)
+    xs.push_back(vit->x());
+  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
+       hit != pwh.holes_end(); ++hit)
+    for (VertexConstIterator vit = hit->vertices_begin();
+         vit != hit->vertices_end(); ++vit)
+      xs.push_back(vit->x());
+  std::sort(xs.begin(), xs.end());
+  xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+
+  // Cut halfway between two consecutive event x-positions.
+  std::vector<FT> cuts;
+  for (size_t i = 1; i < num_slabs; ++i) {
+    size_t id = i * xs.size() / num_slabs;
+    if (id == 0 || id >= xs.size())
+      continue;
+    FT cut = (xs[id - 1] + xs[id]) / 2;
+    if (cuts.empty() || cuts.back() < cut)
+      cuts.push_back(cut);
+  }
+  return cuts;
+}
+
+bool findCutEdge(const Polygon_2 &cell, const FT &x, FT *y_low) {
+  for (EdgeConstIterator it = cell.edges_begin(); it != cell.edges_end();
+       ++it) {
+    if (it->source().x() == x && it->target().x() == x) {
+      *y_low = std::min(it->source().y(), it->target().y());
+      return true;
+    }
+  }
+  return false;
+}
+
+Polygon_2 stitchCells(const Polygon_2 &left, const Polygon_2 &right,
+                      const FT &x) {
+  // Counter-clockwise, the shared edge goes up in the left cell and down in
+  // the right cell.
+  size_t l = 0;
+  while (l < left.size() &&
+         !(left[l].x() == x && left[(l + 1) % left.size()].x() == x))
+    ++l;
+  size_t r = 0;
+  while (r < right.size() &&
+         !(right[r].x() == x && right[(r + 1) % right.size()].x() == x))
+    ++r;
+
+  // Walk the left cell from the upper to the lower cut vertex and continue on
+  // the right cell from the lower to the upper cut vertex.
+  Polygon_2 stitched;
+  for (size_t i = 1; i <= left.size(); ++i)
+    stitched.push_back(left[(l + i) % left.size()]);
+  for (size_t i = 2; i < right.size(); ++i)
+    stitched.push_back(right[(r + i) % right.size()]);
+
+  // The cut vertices lie on edges that were split by the cut.
+  Polygon_2::Vertex_circulator vc = stitched.vertices_circulator();
+  std::vector<Polygon_2::Vertex_circulator> v_to_erase;
+  do {
+    if (vc->x() == x && CGAL::collinear(*std::prev(vc), *vc, *std::next(vc)))
+      v_to_erase.push_back(vc);
+  } while (++vc != stitched.vertices_circulator());
+  for (std::vector<Polygon_2::Vertex_circulator>::reverse_iterator rit =
+           v_to_erase.rbegin();
+       rit != v_to_erase.rend(); ++rit)
+    stitched.erase(*rit);
+
+  return stitched;
+}
 
 //TODO: Memory bottleneck
-std::vector<VertexConstCirculator>
-getXSortedVertices(const PolygonWithHoles &p) {
+template <class Kernel>
+std::vector<typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator>
+getXSortedVertices(const CGAL::Polygon_with_holes_2<Kernel> &p) {
+  typedef typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator
+      VertexConstCirculator;
   std::vector<VertexConstCirculator> sorted_vertices;
 
   // Get boundary vertices.
@@ -86,15 +245,14 @@ getXSortedVertices(const PolygonWithHoles &p) {
     sorted_vertices.push_back(v);
   } while (++v != p.outer_boundary().vertices_circulator());
   // Get hole vertices.
-  for (PolygonWithHoles::Hole_const_iterator hit = p.holes_begin();
-       hit != p.holes_end(); ++hit) {
+  for (auto hit = p.holes_begin(); hit != p.holes_end(); ++hit) {
     VertexConstCirculator vh = hit->vertices_circulator();
     do {
       sorted_vertices.push_back(vh);
     } while (++vh != hit->vertices_circulator());
   }
   // Sort x,y.
-  Polygon_2::Traits::Less_xy_2 less_xy_2;
+  typename Kernel::Less_xy_2 less_xy_2;
   std::sort(sorted_vertices.begin(), sorted_vertices.end(),
             [&less_xy_2](const VertexConstCirculator &a,
                          const VertexConstCirculator &b) -> bool {
@@ -105,31 +263,43 @@ getXSortedVertices(const PolygonWithHoles &p) {
 }
 
 
-void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
-                  std::vector<VertexConstCirculator> *sorted_vertices,
-                  std::vector<Point_2> *processed_vertices,
-                  std::list<Segment_2> *L, std::list<Polygon_2> *open_polygons,
-                  std::vector<Polygon_2> *closed_polygons) {
-
-  Polygon_2::Traits::Equal_2 eq_2;
+template <class Kernel>
+void processEvent(
+    const CGAL::Polygon_with_holes_2<Kernel> &pwh,
+    const typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator &v,
+    std::vector<typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator>
+        *sorted_vertices,
+    std::vector<typename Kernel::Point_2> *processed_vertices,
+    std::list<typename Kernel::Segment_2> *L,
+    std::list<CGAL::Polygon_2<Kernel>> *open_polygons,
+    std::vector<CGAL::Polygon_2<Kernel>> *closed_polygons) {
+  typedef typename Kernel::Point_2 Point_2;
+  typedef typename Kernel::Vector_2 Vector_2;
+  typedef typename Kernel::Direction_2 Direction_2;
+  typedef typename Kernel::Line_2 Line_2;
+  typedef typename Kernel::Segment_2 Segment_2;
+  typedef CGAL::Polygon_2<Kernel> Polygon_2;
+  typedef typename Polygon_2::Vertex_const_circulator VertexConstCirculator;
+
+  typename Polygon_2::Traits::Equal_2 eq_2;
 
   // Compute intersection.
   Line_2 l(*v, Direction_2(0, 1));
-  std::vector<Point_2> intersections = getIntersections(*L, l);
+  std::vector<Point_2> intersections = getIntersections<Kernel>(*L, l);
 
   // Get e_lower and e_upper.
   Segment_2 e_prev(*v, *std::prev(v));
   Segment_2 e_next(*v, *std::next(v));
   // Catch vertical edges.
-  Polygon_2::Traits::Equal_x_2 eq_x_2;
+  typename Polygon_2::Traits::Equal_x_2 eq_x_2;
   if (eq_x_2(e_prev.source(), e_prev.target())) {
     e_prev = Segment_2(*std::prev(v), *std::prev(v, 2));
   } else if (eq_x_2(e_next.source(), e_next.target())) {
     e_next = Segment_2(*std::next(v), *std::next(v, 2));
   }
 
-  Polygon_2::Traits::Less_y_2 less_y_2;
-  Polygon_2::Traits::Less_x_2 less_x_2;
+  typename Polygon_2::Traits::Less_y_2 less_y_2;
+  typename Polygon_2::Traits::Less_x_2 less_x_2;
   Segment_2 e_lower = e_prev;
   Segment_2 e_upper = e_next;
   if (less_x_2(e_prev.target(), e_prev.source()) &&
@@ -147,7 +317,7 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
     bool close_one = outOfPWH(pwh, *v + Vector_2(1e-6, 0));
 
     // Find edges to remove.
-    std::list<Segment_2>::iterator e_lower_it = L->begin();
+    typename std::list<Segment_2>::iterator e_lower_it = L->begin();
     size_t e_lower_id = 0;
     for (; e_lower_it != L->end(); ++e_lower_it) {
       if (*e_lower_it == e_lower || *e_lower_it == e_lower.opposite()) {
@@ -156,16 +326,16 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
       e_lower_id++;
     }
 
-    std::list<Segment_2>::iterator e_upper_it = std::next(e_lower_it);
+    typename std::list<Segment_2>::iterator e_upper_it = std::next(e_lower_it);
     size_t e_upper_id = e_lower_id + 1;
     size_t lower_cell_id = e_lower_id / 2;
     size_t upper_cell_id = e_upper_id / 2;
 
     if (close_one) {
-      std::list<Polygon_2>::iterator cell =
+      typename std::list<Polygon_2>::iterator cell =
           std::next(open_polygons->begin(), lower_cell_id);
       cell->push_back(e_lower.source());
-      Polygon_2::Traits::Equal_2 eq_2;
+      typename Polygon_2::Traits::Equal_2 eq_2;
       if (!eq_2(e_lower.source(), e_upper.source())) {
         cell->push_back(e_upper.source());
       }
@@ -178,14 +348,14 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
       // Close two cells, open one.
       // Close lower cell.
 
-      std::list<Polygon_2>::iterator lower_cell =
+      typename std::list<Polygon_2>::iterator lower_cell =
           std::next(open_polygons->begin(), lower_cell_id);
       lower_cell->push_back(intersections[e_lower_id - 1]);
       lower_cell->push_back(intersections[e_lower_id]);
       if (cleanupPolygon(&*lower_cell))
         closed_polygons->push_back(*lower_cell);
       // Close upper cell.
-      std::list<Polygon_2>::iterator upper_cell =
+      typename std::list<Polygon_2>::iterator upper_cell =
           std::next(open_polygons->begin(), upper_cell_id);
       upper_cell->push_back(intersections[e_upper_id]);
       upper_cell->push_back(intersections[e_upper_id + 1]);
@@ -197,7 +367,7 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
       L->erase(e_upper_it);
 
       // Open one new cell.
-      std::list<Polygon_2>::iterator new_polygon =
+      typename std::list<Polygon_2>::iterator new_polygon =
           open_polygons->insert(lower_cell, Polygon_2());
       new_polygon->push_back(intersections[e_upper_id + 1]);
       new_polygon->push_back(intersections[e_lower_id - 1]);
@@ -212,7 +382,7 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
   } else if (!less_x_2(e_lower.target(), e_lower.source()) &&
              !less_x_2(e_upper.target(), e_upper.source())) {
     // IN
-    Polygon_2::Traits::Equal_2 eq_2;
+    typename Polygon_2::Traits::Equal_2 eq_2;
     Point_2 p_on_lower = eq_2(e_lower.source(), e_upper.source())
                              ? e_lower.target()
                              : e_lower.source();
@@ -243,8 +413,8 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
     }
     if (open_one) {
       // Add one new cell above e_UPPER.
-      std::list<Segment_2>::iterator e_UPPER = L->begin();
-      std::list<Polygon_2>::iterator open_cell = open_polygons->begin();
+      typename std::list<Segment_2>::iterator e_UPPER = L->begin();
+      typename std::list<Polygon_2>::iterator open_cell = open_polygons->begin();
       if (!L->empty() && found_e_lower_id) {
         e_UPPER = std::next(e_UPPER, e_LOWER_id + 1);
         open_cell = std::next(open_cell, e_LOWER_id / 2 + 1);
@@ -257,13 +427,13 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
         L->insert(L->begin(), e_upper);
         L->insert(L->begin(), e_lower);
       } else {
-        std::list<Segment_2>::iterator inserter = std::next(e_UPPER);
+        typename std::list<Segment_2>::iterator inserter = std::next(e_UPPER);
         L->insert(inserter, e_lower);
         L->insert(inserter, e_upper);
       }
 
       // Create new polygon.
-      std::list<Polygon_2>::iterator open_polygon =
+      typename std::list<Polygon_2>::iterator open_polygon =
           open_polygons->insert(open_cell, Polygon_2());
       open_polygon->push_back(e_upper.source());
       if (!eq_2(e_lower.source(), e_upper.source())) {
@@ -271,18 +441,18 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
       }
     } else {
       // Add new polygon between e_LOWER and e_UPPER.
-      std::list<Segment_2>::iterator e_LOWER =
+      typename std::list<Segment_2>::iterator e_LOWER =
           std::next(L->begin(), e_LOWER_id);
-      std::list<Polygon_2>::iterator cell =
+      typename std::list<Polygon_2>::iterator cell =
           std::next(open_polygons->begin(), e_LOWER_id / 2);
 
       // Add e_lower and e_upper
-      std::list<Segment_2>::iterator e_lower_it =
+      typename std::list<Segment_2>::iterator e_lower_it =
           L->insert(std::next(e_LOWER), e_lower);
       L->insert(std::next(e_lower_it), e_upper);
 
       // Add new cell.
-      std::list<Polygon_2>::iterator new_polygon =
+      typename std::list<Polygon_2>::iterator new_polygon =
           open_polygons->insert(cell, Polygon_2());
 
       // Close one cell.
@@ -310,17 +480,17 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
     // TODO(rikba): Sort vertices correctly in the first place.
     // Check if v exits among edges.
     VertexConstCirculator v_middle = v;
-    std::list<Segment_2>::iterator it = L->end();
+    typename std::list<Segment_2>::iterator it = L->end();
     while (it == L->end()) {
       for (it = L->begin(); it != L->end(); it++) {
         if (*v_middle == it->source() || *v_middle == it->target()) {
           // Swap v in sorted vertices.
           if (!eq_2(*v, *v_middle)) {
-            std::vector<VertexConstCirculator>::iterator i_v =
+            typename std::vector<VertexConstCirculator>::iterator i_v =
                 sorted_vertices->end();
-            std::vector<VertexConstCirculator>::iterator i_v_middle =
+            typename std::vector<VertexConstCirculator>::iterator i_v_middle =
                 sorted_vertices->end();
-            for (std::vector<VertexConstCirculator>::iterator it =
+            for (typename std::vector<VertexConstCirculator>::iterator it =
                      sorted_vertices->begin();
                  it != sorted_vertices->end(); ++it) {
               if (*it == v)
@@ -350,7 +520,7 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
     e_next = Segment_2(*v_middle, *std::next(v_middle));
 
     // Find edge to update.
-    std::list<Segment_2>::iterator old_e_it = L->begin();
+    typename std::list<Segment_2>::iterator old_e_it = L->begin();
     Segment_2 new_edge;
     size_t edge_id = 0;
     for (; old_e_it != L->end(); ++old_e_it) {
@@ -366,7 +536,7 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
 
     // Update cell with new vertex.
     size_t cell_id = edge_id / 2;
-    std::list<Polygon_2>::iterator cell =
+    typename std::list<Polygon_2>::iterator cell =
         std::next(open_polygons->begin(), cell_id);
 
     if ((edge_id % 2) == 0) {
@@ -383,14 +553,19 @@ void processEvent(const PolygonWithHoles &pwh, const VertexConstCirculator &v,
     processed_vertices->push_back(*v_middle);
   }
 }
-std::vector<Point_2> getIntersections(const std::list<Segment_2> &L,
-                                      const Line_2 &l) {
-  typedef CGAL::cpp11::result_of<Intersect_2(Segment_2, Line_2)>::type
-      Intersection;
+template <class Kernel>
+std::vector<typename Kernel::Point_2>
+getIntersections(const std::list<typename Kernel::Segment_2> &L,
+                 const typename Kernel::Line_2 &l) {
+  typedef typename Kernel::Point_2 Point_2;
+  typedef typename Kernel::Segment_2 Segment_2;
+  typedef typename Kernel::Line_2 Line_2;
+  typedef typename CGAL::cpp11::result_of<typename Kernel::Intersect_2(
+      Segment_2, Line_2)>::type Intersection;
 
   std::vector<Point_2> intersections(L.size());
-  std::vector<Point_2>::iterator intersection = intersections.begin();
-  for (std::list<Segment_2>::const_iterator it = L.begin(); it != L.end();
+  typename std::vector<Point_2>::iterator intersection = intersections.begin();
+  for (typename std::list<Segment_2>::const_iterator it = L.begin(); it != L.end();
        ++it) {
     Intersection result = CGAL::intersection(*it, l);
     if (result) {
@@ -408,21 +583,22 @@ std::vector<Point_2> getIntersections(const std::list<Segment_2> &L,
   return intersections;
 }
 
-void sortPolygon(PolygonWithHoles *pwh) {
+template <class Kernel>
+void sortPolygon(CGAL::Polygon_with_holes_2<Kernel> *pwh) {
   if (pwh->outer_boundary().is_clockwise_oriented())
     pwh->outer_boundary().reverse_orientation();
 
-  for (PolygonWithHoles::Hole_iterator hi = pwh->holes_begin();
-       hi != pwh->holes_end(); ++hi)
+  for (auto hi = pwh->holes_begin(); hi != pwh->holes_end(); ++hi)
     if (hi->is_counterclockwise_oriented())
       hi->reverse_orientation();
 }
 
-bool cleanupPolygon(Polygon_2 *poly) {
-  Polygon_2::Traits::Equal_2 eq_2;
+template <class Kernel>
+bool cleanupPolygon(CGAL::Polygon_2<Kernel> *poly) {
+  typename Kernel::Equal_2 eq_2;
   bool erase_one = true;
   while (erase_one) {
-    Polygon_2::Vertex_circulator vit = poly->vertices_circulator();
+    typename CGAL::Polygon_2<Kernel>::Vertex_circulator vit = poly->vertices_circulator();
     erase_one = false;
     do {
       if (eq_2(*vit, *std::next(vit))) {
@@ -436,12 +612,13 @@ bool cleanupPolygon(Polygon_2 *poly) {
   return poly->is_simple() && poly->area() != 0.0;
 }
 
-bool outOfPWH(const PolygonWithHoles &pwh, const Point_2 &p) {
+template <class Kernel>
+bool outOfPWH(const CGAL::Polygon_with_holes_2<Kernel> &pwh,
+              const typename Kernel::Point_2 &p) {
   if (pwh.outer_boundary().has_on_unbounded_side(p))
     return true;
 
-  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
-       hit != pwh.holes_end(); ++hit) {
+  for (auto hit = pwh.holes_begin(); hit != pwh.holes_end(); ++hit) {
     if (hit->has_on_bounded_side(p)) {
       return true;
     }
@@ -450,4 +627,22 @@ bool outOfPWH(const PolygonWithHoles &pwh, const Point_2 &p) {
   return false;
 }
 
+// The sweep runs on the exact kernel for the final decomposition and on the
+// inexact kernel to screen sweep directions.
+template std::vector<Polygon_2> computeRotatedBCD(const PolygonWithHoles &);
+template void sortPolygon(PolygonWithHoles *);
+template std::vector<VertexConstCirculator>
+getXSortedVertices(const PolygonWithHoles &);
+template bool outOfPWH(const PolygonWithHoles &, const Point_2 &);
+template bool cleanupPolygon(Polygon_2 *);
+
+template std::vector<InexactPolygon_2>
+computeRotatedBCD(const InexactPolygonWithHoles &);
+template void sortPolygon(InexactPolygonWithHoles *);
+template std::vector<InexactVertexConstCirculator>
+getXSortedVertices(const InexactPolygonWithHoles &);
+template bool outOfPWH(const InexactPolygonWithHoles &,
+                       const InexactKernel::Point_2 &);
+template bool cleanupPolygon(InexactPolygon_2 *);
+
 } // namespace polygon_coverage_planning
@@ -0,0 +1,166 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+
+#include "cell_adjacency.h"
+#include "parallel.h"
+
+namespace polygon_coverage_planning {
+
+namespace {
+
+// The normalized coefficients of a line a*x + b*y + c = 0.
+struct LineKey {
+  FT a, b, c;
+  bool operator<(const LineKey& other) const {
+    if (a != other.a) return a < other.a;
+    if (b != other.b) return b < other.b;
+    return c < other.c;
+  }
+};
+
+// An edge as interval along its supporting line.
+struct BoundaryInterval {
+  FT lo, hi;
+  Point_2 lo_point, hi_point;
+  size_t cell;
+  bool operator<(const BoundaryInterval& other) const { return lo < other.lo; }
+};
+
+LineKey getLineKey(const Segment_2& s) {
+  const Line_2 l = s.supporting_line();
+  LineKey key;
+  if (l.a() != 0) {
+    key.a = 1;
+    key.b = l.b() / l.a();
+    key.c = l.c() / l.a();
+  } else {
+    key.a = 0;
+    key.b = 1;
+    key.c = l.c() / l.b();
+  }
+  return key;
+}
+
+BoundaryInterval getBoundaryInterval(const Segment_2& s, size_t cell) {
+  // Parameterize horizontal lines by x and all others by y.
+  const bool horizontal = s.source().y() == s.target().y();
+  const FT u = horizontal ? s.source().x() : s.source().y();
+  const FT v = horizontal ? s.target().x() : s.target().y();
+  BoundaryInterval interval;
+  interval.lo = std::min(u, v);
+  interval.hi = std::max(u, v);
+  interval.lo_point = u < v ? s.source() : s.target();
+  interval.hi_point = u < v ? s.target() : s.source();
+  interval.cell = cell;
+  return interval;
+}
+
+}  // namespace
+
+void computeCellAdjacency(const std::vector<Polygon_2>& cells,
+                          std::vector<std::vector<size_t>>* neighbors) {
+  computeCellAdjacency(cells, neighbors, nullptr);
+}
+
+void computeCellAdjacency(const std::vector<Polygon_2>& cells,
+                          std::vector<std::vector<size_t>>* neighbors,
+                          SharedBoundaries* shared_boundaries) {
+  neighbors->assign(cells.size(), std::vector<size_t>());
+  if (shared_boundaries) shared_boundaries->clear();
+
+  std::map<LineKey, std::vector<BoundaryInterval>> lines;
+  for (size_t i = 0; i < cells.size(); ++i) {
+    for (EdgeConstIterator e = cells[i].edges_begin();
+         e != cells[i].edges_end(); ++e) {
+      if (e->is_degenerate()) continue;
+      lines[getLineKey(*e)].push_back(getBoundaryInterval(*e, i));
+    }
+  }
+
+  for (auto& line : lines) {
+    std::vector<BoundaryInterval>& intervals = line.second;
+    std::sort(intervals.begin(), intervals.end());
+    // Cells do not overlap, so only few intervals are active at a time.
+    std::vector<const BoundaryInterval*> active;
+    for (const BoundaryInterval& interval : intervals) {
+      active.erase(std::remove_if(active.begin(), active.end(),
+                                  [&interval](const BoundaryInterval* a) {
+                                    return a->hi <= interval.lo;
+                                  }),
+                   active.end());
+      for (const BoundaryInterval* a : active) {
+        if (a->cell == interval.cell) continue;
+        (*neighbors)[a->cell].push_back(interval.cell);
+        (*neighbors)[interval.cell].push_back(a->cell);
+        if (shared_boundaries) {
+          // Sorted by lo, so the overlap starts at interval.lo.
+          const Point_2& end =
+              a->hi < interval.hi ? a->hi_point : interval.hi_point;
+          (*shared_boundaries)[std::minmax(a->cell, interval.cell)].push_back(
+              Segment_2(interval.lo_point, end));
+        }
+      }
+      active.push_back(&interval);
+    }
+  }
+
+  for (std::vector<size_t>& n : *neighbors) {
+    std::sort(n.begin(), n.end());
+    n.erase(std::unique(n.begin(), n.end()), n.end());
+  }
+}
+
+void computeCellDistances(const std::vector<std::vector<Point_2>>& cells_sweeps,
+                          const ShortestPathSolver& free_space_solver,
+                          const CostModel& cost_model,
+                          std::vector<std::vector<double>>* distances) {
+  const size_t n = cells_sweeps.size();
+  distances->assign(n, std::vector<double>(n, kUnreachableCellDistance));
+  std::vector<std::pair<size_t, size_t>> pairs;
+  for (size_t i = 0; i < n; ++i) {
+    (*distances)[i][i] = 0.0;
+    for (size_t j = i + 1; j < n; ++j) {
+      if (!cells_sweeps[i].empty() && !cells_sweeps[j].empty())
+        pairs.emplace_back(i, j);
+    }
+  }
+
+  // Every pair of cells is independent.
+  parallelFor(pairs.size(), [&](size_t k) {
+    const size_t i = pairs[k].first, j = pairs[k].second;
+    const Point_2 from[] = {cells_sweeps[i].front(), cells_sweeps[i].back()};
+    const Point_2 to[] = {cells_sweeps[j].front(), cells_sweeps[j].back()};
+    double cost = kUnreachableCellDistance;
+    std::vector<Point_2> path;
+    for (const Point_2& a : from) {
+      for (const Point_2& b : to) {
+        if (!free_space_solver.solve(a, b, &path) || path.size() < 2)
+          path = {a, b};  // Same fallback as the planned transitions.
+        cost = std::min(cost, cost_model.computeCost(path));
+      }
+    }
+    (*distances)[i][j] = cost;
+    (*distances)[j][i] = cost;
+  });
+}
+
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,151 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "cell_locator.h"
+
+namespace polygon_coverage_planning {
+
+CellLocator::CellLocator(const std::vector<Polygon_2>& cells)
+    : cells_(cells),
+      cols_(1),
+      rows_(1),
+      bucket_width_(1.0),
+      bucket_height_(1.0) {
+  if (cells_.empty()) {
+    buckets_.resize(1);
+    return;
+  }
+
+  std::vector<CGAL::Bbox_2> bboxes;
+  bboxes.reserve(cells_.size());
+  bbox_ = cells_.front().bbox();
+  for (const Polygon_2& cell : cells_) {
+    bboxes.push_back(cell.bbox());
+    bbox_ = bbox_ + bboxes.back();
+  }
+
+  // About one bucket per cell with roughly square buckets.
+  const double width = std::max(bbox_.xmax() - bbox_.xmin(), 1e-9);
+  const double height = std::max(bbox_.ymax() - bbox_.ymin(), 1e-9);
+  const double n = static_cast<double>(cells_.size());
+  cols_ = std::max(
+      1, static_cast<int>(std::ceil(std::sqrt(n * width / height))));
+  rows_ = std::max(1, static_cast<int>(std::ceil(n / cols_)));
+  bucket_width_ = width / cols_;
+  bucket_height_ = height / rows_;
+
+  buckets_.resize(cols_ * rows_);
+  for (size_t i = 0; i < cells_.size(); ++i) {
+    int col_min, col_max, row_min, row_max;
+    getBucketRange(bboxes[i], &col_min, &col_max, &row_min, &row_max);
+    for (int row = row_min; row <= row_max; ++row)
+      for (int col = col_min; col <= col_max; ++col)
+        buckets_[row * cols_ + col].push_back(i);
+  }
+}
+
+void CellLocator::getBucketRange(const CGAL::Bbox_2& box, int* col_min,
+                                 int* col_max, int* row_min,
+                                 int* row_max) const {
+  auto toCol = [this](double x) {
+    const int col =
+        static_cast<int>(std::floor((x - bbox_.xmin()) / bucket_width_));
+    return std::min(std::max(col, 0), cols_ - 1);
+  };
+  auto toRow = [this](double y) {
+    const int row =
+        static_cast<int>(std::floor((y - bbox_.ymin()) / bucket_height_));
+    return std::min(std::max(row, 0), rows_ - 1);
+  };
+  *col_min = toCol(box.xmin());
+  *col_max = toCol(box.xmax());
+  *row_min = toRow(box.ymin());
+  *row_max = toRow(box.ymax());
+}
+
+int CellLocator::locate(const Point_2& p) const {
+  if (cells_.empty()) return -1;
+  // The point box encloses the exact coordinates.
+  const CGAL::Bbox_2 box = p.bbox();
+  if (!CGAL::do_overlap(box, bbox_)) return -1;
+
+  int col_min, col_max, row_min, row_max;
+  getBucketRange(box, &col_min, &col_max, &row_min, &row_max);
+  size_t best = cells_.size();
+  for (int row = row_min; row <= row_max; ++row) {
+    for (int col = col_min; col <= col_max; ++col) {
+      for (size_t i : getBucket(col, row)) {
+        if (i < best && cells_[i].bounded_side(p) != CGAL::ON_UNBOUNDED_SIDE)
+          best = i;
+      }
+    }
+  }
+  return best < cells_.size() ? static_cast<int>(best) : -1;
+}
+
+int CellLocator::locateNearest(const Point_2& p) const {
+  const int id = locate(p);
+  if (id != -1 || cells_.empty()) return id;
+
+  // Search rings of buckets around the point until no closer cell can follow.
+  int col_min, col_max, row_min, row_max;
+  getBucketRange(p.bbox(), &col_min, &col_max, &row_min, &row_max);
+  const int col = col_min, row = row_min;
+  const double min_bucket_size = std::min(bucket_width_, bucket_height_);
+
+  size_t best = cells_.size();
+  FT best_sq_distance = 0;
+  std::vector<size_t> checked;
+  for (int r = 0; r < std::max(cols_, rows_); ++r) {
+    for (int y = row - r; y <= row + r; ++y) {
+      if (y < 0 || y >= rows_) continue;
+      // Inner rows only contribute their outermost buckets.
+      const int step = (y == row - r || y == row + r) ? 1 : std::max(1, 2 * r);
+      for (int x = col - r; x <= col + r; x += step) {
+        if (x < 0 || x >= cols_) continue;
+        for (size_t i : getBucket(x, y)) {
+          if (std::find(checked.begin(), checked.end(), i) != checked.end())
+            continue;
+          checked.push_back(i);
+          for (EdgeConstIterator e = cells_[i].edges_begin();
+               e != cells_[i].edges_end(); ++e) {
+            const FT sq_distance = CGAL::squared_distance(p, *e);
+            if (best == cells_.size() || sq_distance < best_sq_distance ||
+                (sq_distance == best_sq_distance && i < best)) {
+              best = i;
+              best_sq_distance = sq_distance;
+            }
+          }
+        }
+      }
+    }
+    // All buckets beyond ring r are at least r bucket sizes away.
+    const double reach = r * min_bucket_size;
+    if (best < cells_.size() &&
+        CGAL::to_double(best_sq_distance) < reach * reach)
+      break;
+  }
+  return static_cast<int>(best);
+}
+
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,179 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+
+#include <CGAL/Boolean_set_operations_2.h>
+
+#include "cell_adjacency.h"
+#include "cell_merging.h"
+#include "cgal_comm.h"
+#include "decomposition.h"
+#include "weakly_monotone.h"
+
+namespace polygon_coverage_planning {
+
+bool mergeCellPair(const Polygon_2& a, const Polygon_2& b, Polygon_2* merged) {
+  PolygonWithHoles joined;
+  if (!CGAL::join(a, b, joined) || joined.holes_begin() != joined.holes_end())
+    return false;
+
+  *merged = joined.outer_boundary();
+  simplifyPolygon(merged);
+  if (!merged->is_simple()) return false;
+  if (merged->is_clockwise_oriented()) merged->reverse_orientation();
+
+  return !getAllSweepableEdgeDirections(*merged).empty();
+}
+
+namespace {
+
+// Working copy of the decomposition. Merging j into i keeps i and retires j.
+class CellMerger {
+ public:
+  CellMerger(const std::vector<Polygon_2>& cells)
+      : cells_(cells),
+        alive_(cells.size(), true),
+        altitudes_(cells.size()),
+        neighbors_(cells.size()) {
+    SharedBoundaries shared_boundaries;
+    std::vector<std::vector<size_t>> neighbors;
+    computeCellAdjacency(cells_, &neighbors, &shared_boundaries);
+    for (const auto& shared : shared_boundaries) {
+      double length = 0.0;
+      for (const Segment_2& s : shared.second)
+        length += std::sqrt(CGAL::to_double(s.squared_length()));
+      neighbors_[shared.first.first][shared.first.second] = length;
+      neighbors_[shared.first.second][shared.first.first] = length;
+    }
+    for (size_t i = 0; i < cells_.size(); ++i)
+      altitudes_[i] = findBestSweepDir(cells_[i]);
+  }
+
+  // Neighbors of cell i, longest shared boundary first.
+  std::vector<size_t> getNeighbors(size_t i) const {
+    std::vector<std::pair<double, size_t>> sorted;
+    for (const auto& n : neighbors_[i])
+      sorted.emplace_back(-n.second, n.first);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<size_t> neighbors;
+    for (const auto& n : sorted) neighbors.push_back(n.second);
+    return neighbors;
+  }
+
+  void merge(size_t i, size_t j, const Polygon_2& merged) {
+    cells_[i] = merged;
+    altitudes_[i] = findBestSweepDir(cells_[i]);
+    alive_[j] = false;
+    for (const auto& n : neighbors_[j]) {
+      neighbors_[n.first].erase(j);
+      if (n.first == i) continue;
+      neighbors_[i][n.first] += n.second;
+      neighbors_[n.first][i] += n.second;
+    }
+    neighbors_[j].clear();
+  }
+
+  std::vector<Polygon_2> getCells() const {
+    std::vector<Polygon_2> cells;
+    for (size_t i = 0; i < cells_.size(); ++i)
+      if (alive_[i]) cells.push_back(cells_[i]);
+    return cells;
+  }
+
+  size_t size() const { return cells_.size(); }
+  bool isAlive(size_t i) const { return alive_[i]; }
+  const Polygon_2& getCell(size_t i) const { return cells_[i]; }
+  double getAltitude(size_t i) const { return altitudes_[i]; }
+
+ private:
+  std::vector<Polygon_2> cells_;
+  std::vector<bool> alive_;
+  std::vector<double> altitudes_;
+  // Shared boundary length to every adjacent cell.
+  std::vector<std::map<size_t, double>> neighbors_;
+};
+
+}  // namespace
+
+size_t mergeCells(double min_area, double min_width,
+                  std::vector<Polygon_2>* cells) {
+  CellMerger merger(*cells);
+  size_t num_merges = 0;
+
+  // Absorb slivers, smallest first.
+  std::vector<std::pair<double, size_t>> slivers;
+  for (size_t i = 0; i < merger.size(); ++i) {
+    const double area = CGAL::to_double(computeArea(merger.getCell(i)));
+    if (area < min_area || merger.getAltitude(i) < min_width)
+      slivers.emplace_back(area, i);
+  }
+  std::sort(slivers.begin(), slivers.end());
+  for (const auto& sliver : slivers) {
+    const size_t j = sliver.second;
+    if (!merger.isAlive(j)) continue;
+    Polygon_2 merged;
+    for (size_t i : merger.getNeighbors(j)) {
+      if (mergeCellPair(merger.getCell(i), merger.getCell(j), &merged)) {
+        merger.merge(i, j, merged);
+        ++num_merges;
+        break;
+      }
+    }
+  }
+
+  // Merge compatible cells until no pair is left. Rejected pairs are only
+  // retried after one of the cells changed.
+  std::set<std::pair<size_t, size_t>> rejected;
+  bool merged_any = true;
+  while (merged_any) {
+    merged_any = false;
+    for (size_t i = 0; i < merger.size(); ++i) {
+      if (!merger.isAlive(i)) continue;
+      for (size_t j : merger.getNeighbors(i)) {
+        if (j < i || rejected.count(std::make_pair(i, j))) continue;
+        Polygon_2 merged;
+        if (mergeCellPair(merger.getCell(i), merger.getCell(j), &merged) &&
+            findBestSweepDir(merged) <=
+                merger.getAltitude(i) + merger.getAltitude(j)) {
+          merger.merge(i, j, merged);
+          ++num_merges;
+          merged_any = true;
+          // Cell i changed, its pairs are candidates again.
+          for (auto it = rejected.begin(); it != rejected.end();) {
+            if (it->first == i || it->second == i)
+              it = rejected.erase(it);
+            else
+              ++it;
+          }
+          break;
+        }
+        rejected.insert(std::make_pair(i, j));
+      }
+    }
+  }
+
+  *cells = merger.getCells();
+  return num_merges;
+}
+
+}  // namespace polygon_coverage_planning
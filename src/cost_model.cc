@@ -0,0 +1,87 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cost_model.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace polygon_coverage_planning {
+
+// Smaller direction changes, e.g., rounding of waypoints, are no turns.
+const double kCollinearAngle = 1e-6;
+
+CostModel::CostModel() : CostModel(1.0, 0.0, 0.0, 0.0) {}
+
+CostModel::CostModel(double max_speed, double max_acceleration,
+                     double turn_rate, double turn_penalty)
+    : max_speed_(max_speed),
+      max_acceleration_(max_acceleration),
+      turn_rate_(turn_rate),
+      turn_penalty_(turn_penalty) {
+  if (max_speed_ <= 0.0) {
+    std::cout << "Invalid maximum speed " << max_speed_ << ", using 1."
+              << std::endl;
+    max_speed_ = 1.0;
+  }
+}
+
+double CostModel::computeRunTime(double length) const {
+  if (max_acceleration_ <= 0.0) return length / max_speed_;
+
+  // Reaching full speed and braking again covers v^2 / a.
+  const double ramp_length = max_speed_ * max_speed_ / max_acceleration_;
+  if (length >= ramp_length)
+    return length / max_speed_ + max_speed_ / max_acceleration_;
+  return 2.0 * std::sqrt(length / max_acceleration_);
+}
+
+double CostModel::computeTurnTime(double angle) const {
+  const double turn_time = turn_rate_ > 0.0 ? angle / turn_rate_ : 0.0;
+  return turn_time + turn_penalty_;
+}
+
+double CostModel::computeCost(const std::vector<Point_2>& path) const {
+  double cost = 0.0;
+  double run_length = 0.0;
+  double prev_dx = 0.0, prev_dy = 0.0;
+  bool has_prev = false;
+  for (size_t i = 1; i < path.size(); ++i) {
+    const double dx = CGAL::to_double(path[i].x() - path[i - 1].x());
+    const double dy = CGAL::to_double(path[i].y() - path[i - 1].y());
+    if (dx == 0.0 && dy == 0.0) continue;
+
+    // Stop, turn and start a new run if the direction changes.
+    const double angle =
+        has_prev ? std::abs(std::atan2(prev_dx * dy - prev_dy * dx,
+                                       prev_dx * dx + prev_dy * dy))
+                 : 0.0;
+    if (angle > kCollinearAngle) {
+      cost += computeRunTime(run_length) + computeTurnTime(angle);
+      run_length = 0.0;
+    }
+    run_length += std::sqrt(dx * dx + dy * dy);
+    prev_dx = dx;
+    prev_dy = dy;
+    has_prev = true;
+  }
+  return cost + computeRunTime(run_length);
+}
+
+}  // namespace polygon_coverage_planning
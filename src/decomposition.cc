@@ -19,10 +19,12 @@
 
 #include "decomposition.h"
 #include "bcd.h"
+#include "multi_direction_bcd.h"
 #include "tcd.h"
+#include "parallel.h"
 #include "weakly_monotone.h"
-#include <thread>
-#include <mutex>
+#include <algorithm>
+#include <numeric>
 
 namespace polygon_coverage_planning {
 
@@ -72,98 +74,163 @@ std::vector<Direction_2> findPerpEdgeDirections(const PolygonWithHoles &pwh) {
   return directions;
 }
 
-double findBestSweepDir(const Polygon_2 &cell, Direction_2 *best_dir) {
-  // Get all sweepable edges.
-  PolygonWithHoles pwh(cell);
-  std::vector<Direction_2> edge_dirs = getAllSweepableEdgeDirections(cell);
+std::vector<Direction_2> findUniquePerpEdgeDirections(
+    const PolygonWithHoles &pwh) {
+  std::vector<Direction_2> directions = findPerpEdgeDirections(pwh);
+  // Map to [0, 180) degrees, opposite directions become duplicates.
+  for (auto &d : directions) {
+    if (d.dy() < 0 || (d.dy() == 0 && d.dx() < 0))
+      d = -d;
+  }
+
+  // Sort by angle and remove duplicates.
+  std::sort(directions.begin(), directions.end());
+  directions.erase(std::unique(directions.begin(), directions.end()),
+                   directions.end());
+
+  return directions;
+}
+
+template <class Kernel>
+double findBestSweepDir(const CGAL::Polygon_2<Kernel> &cell,
+                        CGAL::Direction_2<Kernel> *best_dir) {
+  // Get all sweepable edges and their altitudes.
+  std::vector<CGAL::Direction_2<Kernel>> edge_dirs;
+  std::vector<double> altitudes;
+  getAllSweepableEdgeDirections(cell, &edge_dirs, &altitudes);
 
   // Find minimum altitude.
   double min_altitude = std::numeric_limits<double>::max();
-  for (const auto &dir : edge_dirs) {
-    auto s = findSouth(cell, Line_2(Point_2(CGAL::ORIGIN), dir));
-    auto n = findNorth(cell, Line_2(Point_2(CGAL::ORIGIN), dir));
-    auto orthogonal_vec =
-        dir.vector().perpendicular(CGAL::Orientation::POSITIVE);
-    Line_2 line_through_n(*n, orthogonal_vec.direction());
-    auto s_proj = line_through_n.projection(*s);
-    double altitude =
-        std::sqrt(CGAL::to_double(CGAL::squared_distance(*n, s_proj)));
-
-    if (altitude < min_altitude) {
-      min_altitude = altitude;
+  for (size_t i = 0; i < edge_dirs.size(); ++i) {
+    if (altitudes[i] < min_altitude) {
+      min_altitude = altitudes[i];
       if (best_dir)
-        *best_dir = dir;
+        *best_dir = edge_dirs[i];
     }
   }
 
   return min_altitude;
 }
 
+template <class Kernel>
+double findBestSweepDir(const CGAL::Polygon_2<Kernel> &cell,
+                        SweepDirCache<Kernel> *cache,
+                        CGAL::Direction_2<Kernel> *best_dir) {
+  CanonicalShape<Kernel> shape(cell);
+  BestSweepDir<Kernel> result;
+  if (!cache->find(shape, &result)) {
+    result.altitude = findBestSweepDir(cell, &result.dir);
+    cache->insert(shape, result);
+  }
+  if (best_dir)
+    *best_dir = result.dir;
+  return result.altitude;
+}
+
+template double findBestSweepDir(const Polygon_2 &, Direction_2 *);
+template double findBestSweepDir(const InexactPolygon_2 &,
+                                 InexactKernel::Direction_2 *);
+template double findBestSweepDir(const Polygon_2 &, SweepDirCache<K> *,
+                                 Direction_2 *);
+template double findBestSweepDir(const InexactPolygon_2 &,
+                                 SweepDirCache<InexactKernel> *,
+                                 InexactKernel::Direction_2 *);
+
+std::vector<size_t> selectFinalists(const std::vector<double> &scores,
+                                    size_t num_candidates) {
+  std::vector<size_t> ranking(scores.size());
+  std::iota(ranking.begin(), ranking.end(), 0);
+  std::stable_sort(ranking.begin(), ranking.end(),
+                   [&scores](size_t a, size_t b) {
+                     return scores[a] < scores[b];
+                   });
+
+  // Failed estimates are negative and always verified.
+  double best_score = -1.0;
+  for (size_t i : ranking) {
+    if (scores[i] >= 0.0) {
+      best_score = scores[i];
+      break;
+    }
+  }
+
+  const size_t num_best = std::max(kNumExactFinalists, num_candidates);
+  size_t num_valid = 0;
+  std::vector<size_t> finalists;
+  for (size_t i : ranking) {
+    if (scores[i] < 0.0) {
+      finalists.push_back(i);
+    } else if (num_valid < num_best ||
+               scores[i] <= best_score * (1.0 + kFinalistTolerance)) {
+      finalists.push_back(i);
+      ++num_valid;
+    }
+  }
+  // Evaluate in angular order.
+  std::sort(finalists.begin(), finalists.end());
+  return finalists;
+}
+
 // TODO: This function uses too much memory
+bool computeBCDCandidates(const PolygonWithHoles &pwh, size_t num_candidates,
+                          std::vector<std::vector<Polygon_2>> *candidates) {
+  candidates->clear();
+
+  // Get all possible decomposition directions. Opposite directions give the
+  // same decomposition and are only evaluated once.
+  MultiDirectionBCD direction_bcd(pwh);
+  const std::vector<Direction_2>& directions = direction_bcd.getDirections();
+  if (directions.empty())
+    return false;
+
+  const size_t num_threads = getNumThreads();
+  std::cout << "Number of threads detected: " << num_threads << std::endl;
+
+  // Screen all directions with double precision. Every direction writes its
+  // own score.
+  std::vector<double> scores(directions.size());
+  parallelFor(directions.size(), [&](size_t i) {
+    direction_bcd.estimate(i, i + 1, &scores);
+  }, num_threads);
+
+  // Verify the finalists with the exact kernel. The exact decomposition gives
+  // robust cell geometry, the final choice uses its altitude sums.
+  std::vector<size_t> finalists = selectFinalists(scores, num_candidates);
+  std::cout << "Verifying " << finalists.size() << " of " << directions.size()
+            << " sweep directions." << std::endl;
+
+  // Use the spare cores to split every single decomposition into slabs.
+  const size_t num_slabs = std::max<size_t>(1, num_threads / finalists.size());
+  std::vector<std::vector<Polygon_2>> finalist_cells(finalists.size());
+  std::vector<double> altitude_sums(finalists.size());
+  parallelFor(finalists.size(), [&](size_t i) {
+    altitude_sums[i] = direction_bcd.evaluate(
+        finalists[i], finalists[i] + 1, num_slabs, &finalist_cells[i]);
+  }, num_threads);
+
+  std::vector<size_t> order(finalists.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&altitude_sums](size_t a, size_t b) {
+                     return altitude_sums[a] < altitude_sums[b];
+                   });
+  for (size_t i : order) {
+    if (candidates->size() == num_candidates) break;
+    if (finalist_cells[i].empty()) continue;
+    candidates->push_back(std::move(finalist_cells[i]));
+  }
+
+  return !candidates->empty();
+}
+
 bool computeBestBCDFromPolygonWithHoles(const PolygonWithHoles &pwh,
                                         std::vector<Polygon_2> *bcd_polygons) {
   bcd_polygons->clear();
-  double min_altitude_sum = std::numeric_limits<double>::max();
-  std::mutex mtx; // Mutex to access shared variables (min_altitude_sum, bcd_polygons)
 
-  // Get all possible decomposition directions.
-  std::vector<Direction_2> directions = findPerpEdgeDirections(pwh);
+  std::vector<std::vector<Polygon_2>> candidates;
+  if (!computeBCDCandidates(pwh, 1, &candidates)) return false;
+  *bcd_polygons = std::move(candidates.front());
 
-  // Get number of CPU cores
-  unsigned int num_threads = std::thread::hardware_concurrency();
-  std::cout << "Number of threads detected: " << num_threads << std::endl;
-  if (num_threads == 0) num_threads = 1; // Default
-
-  // If directions.size() < num_threads then spawn only directions.size() threads
-  num_threads = std::min(num_threads, static_cast<unsigned int>(directions.size()));
-  size_t chunk_size = directions.size() / num_threads;
-  std::vector<std::thread> threads;
-
-  // Threading to solve for chunks
-  auto computeChunk = [&](size_t start, size_t end) {
-      // Each thread computes a chunk of directions
-      double local_min_altitude_sum = std::numeric_limits<double>::max();
-      std::vector<Polygon_2> local_best_bcd;
-
-      for (size_t i = start; i < end; ++i) {
-          const Direction_2& dir = directions[i];
-          std::vector<Polygon_2> cells = computeBCD(pwh, dir);
-
-          double min_altitude_sum_tmp = 0.0;
-          for (const auto& cell : cells) {
-              min_altitude_sum_tmp += findBestSweepDir(cell);
-          }
-
-          // Update the local best result for this thread
-          if (min_altitude_sum_tmp < local_min_altitude_sum) {
-              local_min_altitude_sum = min_altitude_sum_tmp;
-              local_best_bcd = cells;
-          }
-      }
-
-      // Update global result using shared variable 
-      std::lock_guard<std::mutex> lock(mtx);
-      if (local_min_altitude_sum < min_altitude_sum) {
-          min_altitude_sum = local_min_altitude_sum;
-          *bcd_polygons = std::move(local_best_bcd);
-      }
-  };
-
-  //Create threads to compute chunks of directions
-  for (size_t i = 0; i < num_threads; ++i) {
-      size_t start = i * chunk_size;
-      // To handle case where directions.size() not divisible by number of threads
-      // Last thread would handle to direction.size()
-      size_t end = (i == num_threads - 1) ? directions.size() : start + chunk_size;
-
-      threads.emplace_back(computeChunk, start, end);
-  }
-
-  // Join all the threads
-  for (auto& thread : threads) {
-      thread.join();
-  }
-  
   if (bcd_polygons -> empty())
     return false;
   else
@@ -195,6 +262,19 @@ bool computeBestBCDFromPolygonWithHoles(const PolygonWithHoles &pwh,
   //   return true;
 }
 
+bool computeBestBCDFromPolygonWithHoles(
+    const PolygonWithHoles &pwh, std::vector<Polygon_2> *bcd_polygons,
+    std::vector<std::vector<size_t>> *neighbors,
+    SharedBoundaries *shared_boundaries) {
+  if (!computeBestBCDFromPolygonWithHoles(pwh, bcd_polygons))
+    return false;
+
+  // The cells are only final after cleanup and stitching, so the shared
+  // boundaries are recorded from the final cells.
+  computeCellAdjacency(*bcd_polygons, neighbors, shared_boundaries);
+  return true;
+}
+
 bool computeBestTCDFromPolygonWithHoles(const PolygonWithHoles &pwh,
                                         std::vector<Polygon_2> *tcd_polygons) {
   tcd_polygons->clear();
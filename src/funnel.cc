@@ -0,0 +1,190 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <queue>
+
+#include "cgal_comm.h"
+#include "funnel.h"
+
+namespace polygon_coverage_planning {
+
+void pullString(const std::vector<Portal>& portals,
+                std::vector<Point_2>* waypoints) {
+  waypoints->clear();
+  if (portals.empty())
+    return;
+
+  // Simple stupid funnel algorithm.
+  // http://digestingduck.blogspot.com/2010/03/simple-stupid-funnel-algorithm.html
+  Point_2 apex = portals.front().first;
+  Point_2 left = portals.front().first;
+  Point_2 right = portals.front().second;
+  size_t apex_id = 0, left_id = 0, right_id = 0;
+  waypoints->push_back(apex);
+
+  for (size_t i = 1; i < portals.size(); ++i) {
+    const Point_2& l = portals[i].first;
+    const Point_2& r = portals[i].second;
+
+    // Tighten the right side of the funnel.
+    if (CGAL::orientation(apex, right, r) != CGAL::RIGHT_TURN) {
+      if (apex == right ||
+          CGAL::orientation(apex, left, r) == CGAL::RIGHT_TURN) {
+        right = r;
+        right_id = i;
+      } else {
+        // Right crosses left. Left becomes the new apex.
+        apex = left;
+        apex_id = left_id;
+        waypoints->push_back(apex);
+        left = right = apex;
+        left_id = right_id = apex_id;
+        i = apex_id;
+        continue;
+      }
+    }
+
+    // Tighten the left side of the funnel.
+    if (CGAL::orientation(apex, left, l) != CGAL::LEFT_TURN) {
+      if (apex == left ||
+          CGAL::orientation(apex, right, l) == CGAL::LEFT_TURN) {
+        left = l;
+        left_id = i;
+      } else {
+        // Left crosses right. Right becomes the new apex.
+        apex = right;
+        apex_id = right_id;
+        waypoints->push_back(apex);
+        left = right = apex;
+        left_id = right_id = apex_id;
+        i = apex_id;
+        continue;
+      }
+    }
+  }
+
+  const Point_2& goal = portals.back().first;
+  if (waypoints->back() != goal)
+    waypoints->push_back(goal);
+}
+
+FunnelSolver::FunnelSolver(const Polygon_2& polygon) : polygon_(polygon) {
+  triangulatePolygon(polygon_, &cdt_, &faces_);
+  buildTree();
+}
+
+void FunnelSolver::buildTree() {
+  parent_.assign(faces_.size(), -1);
+  depth_.assign(faces_.size(), 0);
+  std::vector<bool> visited(faces_.size(), false);
+  for (size_t root = 0; root < faces_.size(); ++root) {
+    if (visited[root])
+      continue;
+    visited[root] = true;
+    std::queue<size_t> queue;
+    queue.push(root);
+    while (!queue.empty()) {
+      const size_t id = queue.front();
+      queue.pop();
+      for (int i = 0; i < 3; ++i) {
+        FaceHandle n = faces_[id]->neighbor(i);
+        if (cdt_.is_infinite(n) || !n->info().inDomain() ||
+            cdt_.is_constrained(CDT::Edge(faces_[id], i)))
+          continue;
+        const size_t n_id = static_cast<size_t>(n->info().id);
+        if (visited[n_id])
+          continue;
+        visited[n_id] = true;
+        parent_[n_id] = static_cast<int>(id);
+        depth_[n_id] = depth_[id] + 1;
+        queue.push(n_id);
+      }
+    }
+  }
+}
+
+std::vector<FaceHandle> FunnelSolver::findChannel(
+    const FaceHandle& start, const FaceHandle& goal) const {
+  int s = start->info().id;
+  int g = goal->info().id;
+  std::vector<FaceHandle> from_start, from_goal;
+  while (s != g && s != -1 && g != -1) {
+    if (depth_[s] >= depth_[g]) {
+      from_start.push_back(faces_[s]);
+      s = parent_[s];
+    } else {
+      from_goal.push_back(faces_[g]);
+      g = parent_[g];
+    }
+  }
+  // Different components.
+  if (s != g)
+    return std::vector<FaceHandle>();
+
+  from_start.push_back(faces_[s]);
+  from_start.insert(from_start.end(), from_goal.rbegin(), from_goal.rend());
+  return from_start;
+}
+
+bool FunnelSolver::solve(const Point_2& start, const Point_2& goal,
+                         std::vector<Point_2>* waypoints) const {
+  waypoints->clear();
+
+  // Make sure start and end are inside the polygon.
+  const Point_2 start_new = pointInPolygon(polygon_, start)
+                                ? start
+                                : projectPointOnHull(polygon_, start);
+  const Point_2 goal_new = pointInPolygon(polygon_, goal)
+                               ? goal
+                               : projectPointOnHull(polygon_, goal);
+
+  FaceHandle start_face, goal_face;
+  std::unique_lock<std::mutex> lock(locate_mutex_);
+  const bool located = locateFace(cdt_, start_new, &start_face) &&
+                       locateFace(cdt_, goal_new, &goal_face);
+  lock.unlock();
+  if (!located) {
+    std::cout << "Cannot locate start or goal in triangulation." << std::endl;
+    return false;
+  }
+
+  std::vector<FaceHandle> channel = findChannel(start_face, goal_face);
+  if (channel.empty()) {
+    std::cout << "Start and goal are not connected." << std::endl;
+    return false;
+  }
+
+  std::vector<Portal> portals;
+  portals.reserve(channel.size() + 1);
+  portals.push_back(std::make_pair(start_new, start_new));
+  for (size_t i = 0; i + 1 < channel.size(); ++i) {
+    Portal portal;
+    getPortal(channel[i], channel[i + 1], &portal.first, &portal.second);
+    portals.push_back(portal);
+  }
+  portals.push_back(std::make_pair(goal_new, goal_new));
+
+  pullString(portals, waypoints);
+  if (waypoints->size() == 1)
+    waypoints->push_back(goal_new);
+  return true;
+}
+
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,141 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iterator>
+#include <numeric>
+
+#include <CGAL/convex_hull_2.h>
+
+#include "cgal_comm.h"
+#include "hole_filter.h"
+
+namespace polygon_coverage_planning {
+
+bool polygonsIntersect(const Polygon_2& a, const Polygon_2& b) {
+  if (!CGAL::do_overlap(a.bbox(), b.bbox())) return false;
+
+  for (auto ea = a.edges_begin(); ea != a.edges_end(); ++ea)
+    for (auto eb = b.edges_begin(); eb != b.edges_end(); ++eb)
+      if (CGAL::do_intersect(*ea, *eb)) return true;
+
+  // No boundary contact, so either one contains the other or they are apart.
+  return a.bounded_side(*b.vertices_begin()) == CGAL::ON_BOUNDED_SIDE ||
+         b.bounded_side(*a.vertices_begin()) == CGAL::ON_BOUNDED_SIDE;
+}
+
+namespace {
+
+size_t findRoot(size_t i, std::vector<size_t>* parent) {
+  while ((*parent)[i] != i) {
+    (*parent)[i] = (*parent)[(*parent)[i]];
+    i = (*parent)[i];
+  }
+  return i;
+}
+
+// Smallest distance between the boundaries of two polygons, skipped if the
+// bounding boxes are farther apart than max_distance.
+bool isCloserThan(const Polygon_2& a, const Polygon_2& b, double max_distance) {
+  const CGAL::Bbox_2 box_a = a.bbox(), box_b = b.bbox();
+  if (box_a.xmin() - max_distance > box_b.xmax() ||
+      box_b.xmin() - max_distance > box_a.xmax() ||
+      box_a.ymin() - max_distance > box_b.ymax() ||
+      box_b.ymin() - max_distance > box_a.ymax())
+    return false;
+
+  const FT max_sq_distance = max_distance * max_distance;
+  for (auto ea = a.edges_begin(); ea != a.edges_end(); ++ea)
+    for (auto eb = b.edges_begin(); eb != b.edges_end(); ++eb)
+      if (CGAL::squared_distance(*ea, *eb) < max_sq_distance) return true;
+  return false;
+}
+
+}  // namespace
+
+size_t filterHoles(const Polygon_2& outer, double min_area,
+                   double max_cluster_area, double cluster_distance,
+                   std::vector<Polygon_2>* holes) {
+  const size_t num_holes = holes->size();
+
+  // Drop speckles and degenerate outlines.
+  std::vector<Polygon_2> kept;
+  for (Polygon_2& hole : *holes) {
+    if (hole.size() > 3) simplifyPolygon(&hole);
+    if (hole.size() < 3) continue;
+    if (CGAL::to_double(CGAL::abs(hole.area())) < min_area) continue;
+    kept.push_back(hole);
+  }
+
+  // Cluster the small holes that are closer than cluster_distance.
+  std::vector<size_t> small;
+  for (size_t i = 0; i < kept.size(); ++i)
+    if (CGAL::to_double(CGAL::abs(kept[i].area())) < max_cluster_area)
+      small.push_back(i);
+  std::vector<size_t> parent(kept.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  for (size_t i = 0; i < small.size(); ++i)
+    for (size_t j = i + 1; j < small.size(); ++j)
+      if (isCloserThan(kept[small[i]], kept[small[j]], cluster_distance))
+        parent[findRoot(small[i], &parent)] = findRoot(small[j], &parent);
+
+  std::vector<std::vector<size_t>> clusters(kept.size());
+  for (size_t i = 0; i < kept.size(); ++i)
+    clusters[findRoot(i, &parent)].push_back(i);
+
+  // Replace every cluster by its hull if the hull fits in between the rest.
+  std::vector<bool> removed(kept.size(), false);
+  std::vector<Polygon_2> hulls;
+  for (const std::vector<size_t>& cluster : clusters) {
+    if (cluster.size() < 2) continue;
+
+    std::vector<Point_2> points;
+    for (size_t i : cluster)
+      points.insert(points.end(), kept[i].vertices_begin(),
+                    kept[i].vertices_end());
+    std::vector<Point_2> hull_points;
+    CGAL::convex_hull_2(points.begin(), points.end(),
+                        std::back_inserter(hull_points));
+    Polygon_2 hull(hull_points.begin(), hull_points.end());
+
+    bool valid = outer.bounded_side(*hull.vertices_begin()) ==
+                 CGAL::ON_BOUNDED_SIDE;
+    for (auto e = hull.edges_begin(); valid && e != hull.edges_end(); ++e)
+      for (auto o = outer.edges_begin(); valid && o != outer.edges_end(); ++o)
+        valid = !CGAL::do_intersect(*e, *o);
+    const size_t root = findRoot(cluster.front(), &parent);
+    for (size_t i = 0; valid && i < kept.size(); ++i)
+      valid = removed[i] || findRoot(i, &parent) == root ||
+              !polygonsIntersect(hull, kept[i]);
+    for (size_t i = 0; valid && i < hulls.size(); ++i)
+      valid = !polygonsIntersect(hull, hulls[i]);
+    if (!valid) continue;
+
+    for (size_t i : cluster) removed[i] = true;
+    hull.reverse_orientation();
+    hulls.push_back(hull);
+  }
+
+  holes->clear();
+  for (size_t i = 0; i < kept.size(); ++i)
+    if (!removed[i]) holes->push_back(kept[i]);
+  holes->insert(holes->end(), hulls.begin(), hulls.end());
+  return num_holes - holes->size();
+}
+
+}  // namespace polygon_coverage_planning
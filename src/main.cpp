@@ -8,6 +8,7 @@
 #define DENSE_PATH
 #include <fstream>
 #include <cmath>
+#include <limits>
 #include <vector>
 #include <utility>
 
@@ -15,6 +16,7 @@
 #define WAYPOINT_COORDINATE_FILE_PATH "../result/waypoints.txt"
 #define EXTERNAL_POLYGON_FILE_PATH "../result/ext_polygon_coord.txt"
 #define REGION_OF_INTEREST_FILE_PATH "../result/roi_points.txt"
+#define WAYPOINT_STREAM_FILE_PATH "../result/waypoints_stream.txt"
 
 std::string image_path;
 uint robot_width;
@@ -31,6 +33,30 @@ bool crop_region;
 uint start_x;
 uint start_y;
 uint subdivision_dist;
+uint benchmark_queries = 0;
+bool stream_waypoints = false;
+int cell_order = 0;
+double tsp_time_budget = 1.0;
+bool select_sweep_variants = false;
+uint direction_candidates = 1;
+bool merge_cells = false;
+double simplification_tolerance = 3.0;
+uint max_polygon_vertices = 0;
+double snap_angle = 0.0;
+double min_hole_area = 0.0;
+double max_cluster_hole_area = 0.0;
+double hole_cluster_gap = 0.0;
+double min_cell_area = 0.0;
+double min_cell_width = 0.0;
+bool tune_sweep_directions = false;
+double max_speed = 1.0;
+double max_acceleration = 0.0;
+double turn_rate = 0.0;
+double turn_penalty = 0.0;
+int end_x = -1;
+int end_y = -1;
+polygon_coverage_planning::ShortestPathEngine shortest_path_engine =
+    polygon_coverage_planning::ShortestPathEngine::kVisibilityGraph;
 std::vector<cv::Point> selected_points;
 cv::Mat img_copy;
 cv::Point top_left;
@@ -74,10 +100,102 @@ bool LoadParameters() {
     } else if (param == "CROP_REGION") {
       //Allow user to define the region of interest
       in >> crop_region;
+    } else if (param == "SHORTEST_PATH_ENGINE") {
+      // 0: visibility graph, 1: navigation mesh
+      int engine;
+      in >> engine;
+      if (polygon_coverage_planning::checkShortestPathEngineValid(engine)) {
+        shortest_path_engine =
+            static_cast<polygon_coverage_planning::ShortestPathEngine>(engine);
+      } else {
+        std::cerr << "Invalid shortest path engine: " << engine << std::endl;
+      }
+    } else if (param == "STREAM_WAYPOINTS") {
+      // Emit every cell as soon as it is planned (automatic orientation only)
+      in >> stream_waypoints;
+    } else if (param == "TUNE_SWEEP_DIRECTIONS") {
+      // Sweep every cell in the direction of the cheapest path according to
+      // the cost model instead of the smallest altitude
+      in >> tune_sweep_directions;
+    } else if (param == "MAX_SPEED") {
+      // Cost model: pixels per second
+      in >> max_speed;
+    } else if (param == "MAX_ACCELERATION") {
+      // Cost model: pixels per second squared, 0 is unlimited
+      in >> max_acceleration;
+    } else if (param == "TURN_RATE") {
+      // Cost model: in-place turn rate in radians per second, 0 is unlimited
+      in >> turn_rate;
+    } else if (param == "TURN_PENALTY") {
+      // Cost model: extra seconds per turn
+      in >> turn_penalty;
+    } else if (param == "SIMPLIFICATION") {
+      // Contour tolerance (pixels) and total vertex budget, 0 is no budget
+      in >> simplification_tolerance;
+      in >> max_polygon_vertices;
+    } else if (param == "SNAP_ANGLE") {
+      // Snap edges within this many degrees of the main direction, 0 is off
+      in >> snap_angle;
+    } else if (param == "HOLE_FILTER") {
+      // Minimum hole area, maximum area of clustered holes and the largest
+      // gap between clustered holes, e.g., the robot width (pixels)
+      in >> min_hole_area;
+      in >> max_cluster_hole_area;
+      in >> hole_cluster_gap;
+    } else if (param == "MERGE_CELLS") {
+      // Merge slivers and compatible adjacent cells after the decomposition
+      in >> merge_cells;
+    } else if (param == "MIN_CELL_SIZE") {
+      // Cells below this area or width (pixels) are absorbed by a neighbor
+      in >> min_cell_area;
+      in >> min_cell_width;
+    } else if (param == "DIRECTION_CANDIDATES") {
+      // Number of best decomposition directions compared by their complete
+      // plans, 1 keeps the direction with the smallest altitude sum
+      in >> direction_candidates;
+    } else if (param == "SELECT_SWEEP_VARIANTS") {
+      // Choose among all sweeps of every cell for the shortest total plan
+      // (automatic orientation only)
+      in >> select_sweep_variants;
+    } else if (param == "CELL_ORDER") {
+      // 0: depth first search, 1: TSP over the cell distances
+      in >> cell_order;
+    } else if (param == "TSP_TIME_BUDGET") {
+      // Seconds to improve large TSP instances
+      in >> tsp_time_budget;
+    } else if (param == "END_POS") {
+      // Fixed end point, e.g., a docking station, -1 -1 is none
+      in >> end_x;
+      in >> end_y;
+    } else if (param == "BENCHMARK_SHORTEST_PATH") {
+      // Number of random queries to compare the shortest path engines, 0 is off
+      in >> benchmark_queries;
     }
   }
   in.close();
 
+  // Streaming hands out the sweeps of every cell before the whole plan is
+  // known, so it cannot tune or select the sweeps or order the cells for the
+  // complete plan.
+  if (stream_waypoints && !manual_orientation) {
+    if (tune_sweep_directions) {
+      std::cerr << "TUNE_SWEEP_DIRECTIONS is ignored with STREAM_WAYPOINTS."
+                << std::endl;
+      tune_sweep_directions = false;
+    }
+    if (select_sweep_variants) {
+      std::cerr << "SELECT_SWEEP_VARIANTS is ignored with STREAM_WAYPOINTS."
+                << std::endl;
+      select_sweep_variants = false;
+    }
+    if (cell_order == 1) {
+      std::cerr << "CELL_ORDER 1 is ignored with STREAM_WAYPOINTS, the TSP "
+                   "needs all sweeps first."
+                << std::endl;
+      cell_order = 0;
+    }
+  }
+
   // Log the loaded parameters
   std::cout << "Parameters Loaded:" << std::endl;
   std::cout << "image_path: " << image_path << std::endl;
@@ -88,10 +206,40 @@ bool LoadParameters() {
   std::cout << "sweep_step: " << sweep_step << std::endl;
   std::cout << "show_cells: " << show_cells << std::endl;
   std::cout << "mouse_select_start: " << mouse_select_start << std::endl;
+  std::cout << "shortest_path_engine: "
+            << polygon_coverage_planning::getShortestPathEngineName(
+                   shortest_path_engine)
+            << std::endl;
 
   return true;
 }
 
+// Intermediate points between p1 and p2 about subdivision_dist apart, e.g.,
+// finer waypoints for the ros navstack. Empty if subdivision is disabled.
+std::vector<cv::Point> subdivideSegment(const cv::Point& p1,
+                                        const cv::Point& p2) {
+  std::vector<cv::Point> newPoints;
+  if (subdivision_dist == 0) return newPoints;
+
+  double euclidean_dist = std::sqrt(std::pow(p2.x - p1.x, 2) + std::pow(p2.y - p1.y, 2));
+  // std::cout << "euclidean_dist: " << euclidean_dist << std::endl;
+  double number_of_subdivisions = std::round(euclidean_dist / subdivision_dist);
+  // std::cout << "# of subdivisions: " << number_of_subdivisions << std::endl;
+
+  // Compute the step increments based on the number of subdivisions
+  double stepX = (p2.x - p1.x) / static_cast<double>(number_of_subdivisions + 1);
+  double stepY = (p2.y - p1.y) / static_cast<double>(number_of_subdivisions + 1);
+
+  // Add intermediate points
+  for (int i = 1; i <= number_of_subdivisions; ++i) {
+    cv::Point intermediatePoint;
+    intermediatePoint.x = std::round(p1.x + stepX * i);
+    intermediatePoint.y = std::round(p1.y + stepY * i);
+    newPoints.push_back(intermediatePoint);
+  }
+  return newPoints;
+}
+
 void mouseCallback(int event, int x, int y, int flags, void* param) {
     if (event == cv::EVENT_LBUTTONDOWN && selected_points.size() < 4) {
         selected_points.push_back(cv::Point(x, y));
@@ -138,6 +286,8 @@ int main() {
   if (!LoadParameters()) {
     return EXIT_FAILURE;
   }
+  const polygon_coverage_planning::CostModel cost_model(
+      max_speed, max_acceleration, turn_rate, turn_penalty);
 
   // Read image to be processed
   cv::Mat original_img = cv::imread(image_path);
@@ -265,17 +415,31 @@ int main() {
   std::vector<cv::Point> poly;
   std::vector<std::vector<cv::Point>> polys;
 
+  // Simplify all contours together, so that the outline and the holes never
+  // cross
+  std::vector<Polygon_2> rings;
   for (auto &contour : contours) {
-    cv::approxPolyDP(contour, poly, 3, true);
-    if(crop_region){
-      std::vector<cv::Point> translated_poly;
-      for (const auto& point : poly) {
-          translated_poly.push_back(point + top_left);
-      }
-      polys.emplace_back(translated_poly);
-    } else {
-      polys.emplace_back(poly);
+    Polygon_2 ring;
+    for (const auto &point : contour) {
+      const cv::Point translated = crop_region ? point + top_left : point;
+      ring.push_back(Point_2(translated.x, translated.y));
+    }
+    rings.push_back(ring);
+  }
+  size_t num_contour_vertices = 0;
+  for (const auto &ring : rings) {
+    num_contour_vertices += ring.size();
+  }
+  const size_t num_removed = polygon_coverage_planning::simplifyRings(
+      simplification_tolerance, max_polygon_vertices, &rings);
+  std::cout << "Simplified contours from " << num_contour_vertices << " to "
+            << num_contour_vertices - num_removed << " vertices" << std::endl;
+  for (const auto &ring : rings) {
+    for (const auto &point : ring.container()) {
+      poly.emplace_back(cv::Point(CGAL::to_double(point.x()),
+                                  CGAL::to_double(point.y())));
     }
+    polys.emplace_back(poly);
     poly.clear();
   }
   for (int i = 0; i < polys.size(); i++) {
@@ -330,38 +494,69 @@ int main() {
   int main_deg = (it - line_deg_histogram.begin());
   std::cout << "main deg: " << main_deg << std::endl;
 
+  // Straighten edges that nearly follow the main direction or its normal.
+  // main_deg is measured with the image y-axis pointing up.
+  if (snap_angle > 0.0) {
+    const double main_rad = main_deg * M_PI / 180.0;
+    const size_t num_snapped = polygon_coverage_planning::snapRingsToDirection(
+        Direction_2(std::cos(main_rad), -std::sin(main_rad)),
+        snap_angle * M_PI / 180.0, simplification_tolerance, &rings);
+    std::cout << "Snapped " << num_snapped << " of " << rings.size()
+              << " contours to the main direction" << std::endl;
+  }
+
   // file stream to write external polygon vertices to
   std::ofstream out_ext_poly(EXTERNAL_POLYGON_FILE_PATH);
 
   // construct polygon with holes
+  Polygon_2 outer_polygon = rings.front();
+  out_ext_poly << outer_polygon.size() << std::endl;
 
-  std::vector<cv::Point> outer_poly = polys.front();
-  polys.erase(polys.begin());
-  std::vector<std::vector<cv::Point>> inner_polys = polys;
-
-  Polygon_2 outer_polygon;
-  out_ext_poly << outer_poly.size() << std::endl;
-
-  for (const auto &point : outer_poly) {
-    outer_polygon.push_back(Point_2(point.x, point.y));
-    out_ext_poly << point.x << " " << point.y << std::endl;
+  for (const auto &point : outer_polygon.container()) {
+    out_ext_poly << CGAL::to_double(point.x()) << " "
+                 << CGAL::to_double(point.y()) << std::endl;
   }
 
   // close the file stream
   out_ext_poly.close();
 
-  int num_holes = inner_polys.size();
-  std::vector<Polygon_2> holes(num_holes);
-  for (int i = 0; i < inner_polys.size(); i++) {
-    for (const auto &point : inner_polys[i]) {
-      holes[i].push_back(Point_2(point.x, point.y));
+  int num_holes = rings.size() - 1;
+  std::vector<Polygon_2> holes;
+  for (int i = 1; i < rings.size(); i++) {
+    if (rings[i].size() >= 3) {
+      holes.push_back(rings[i]);
     }
   }
 
+  // Speckles and clutter would add many decomposition events and cells
+  if (min_hole_area > 0.0 || max_cluster_hole_area > 0.0) {
+    polygon_coverage_planning::filterHoles(outer_polygon, min_hole_area,
+                                           max_cluster_hole_area,
+                                           hole_cluster_gap, &holes);
+    std::cout << "Reduced " << num_holes << " holes to " << holes.size()
+              << " holes." << std::endl;
+  }
+
   PolygonWithHoles pwh(outer_polygon, holes.begin(), holes.end());
 
   std::cout << "constructed polygons" << std::endl;
 
+  if (benchmark_queries > 0) {
+    benchmarkShortestPathEngines(pwh, benchmark_queries);
+  }
+
+  // Get starting point from mouse click, candidate decompositions are scored
+  // from it
+  Point_2 start;
+  if (mouse_select_start) {
+    std::cout << "Select starting point" << std::endl;
+    //start = getStartingPoint(original_img);
+    start = getStartingPoint(poly_canvas);
+  } else {
+    start = Point_2(start_x, start_y);
+    std::cout << "Starting point configured: (" << start.x() << ", " << start.y() << ")" << std::endl;
+  }
+
   // cell decomposition
   // TODO: Bottleneck for memory space
 
@@ -370,11 +565,68 @@ int main() {
   // To measure the time it takes to execute cell decomposition
   auto start_time = std::chrono::high_resolution_clock::now();
   std::vector<Polygon_2> bcd_cells;
+  std::vector<std::vector<size_t>> cell_neighbors;
 
   //    polygon_coverage_planning::computeBestTCDFromPolygonWithHoles(pwh,
   //    &bcd_cells);
-  polygon_coverage_planning::computeBestBCDFromPolygonWithHoles(pwh,
-                                                                &bcd_cells);
+  if (direction_candidates > 1) {
+    std::vector<std::vector<Polygon_2>> bcd_candidates;
+    if (!polygon_coverage_planning::computeBCDCandidates(
+            pwh, direction_candidates, &bcd_candidates)) {
+      std::cerr << "Cannot compute any candidate decomposition." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (merge_cells) {
+      std::vector<size_t> num_cells(bcd_candidates.size());
+      for (size_t i = 0; i < bcd_candidates.size(); ++i)
+        num_cells[i] = bcd_candidates[i].size();
+      polygon_coverage_planning::parallelFor(
+          bcd_candidates.size(), [&](size_t i) {
+            polygon_coverage_planning::mergeCells(
+                min_cell_area, min_cell_width, &bcd_candidates[i]);
+          });
+      // Report after the parallel loop to keep the output in order.
+      for (size_t i = 0; i < bcd_candidates.size(); ++i) {
+        std::cout << "Candidate " << i << ": Merged " << num_cells[i]
+                  << " cells into " << bcd_candidates[i].size() << " cells."
+                  << std::endl;
+      }
+    }
+    std::unique_ptr<polygon_coverage_planning::ShortestPathSolver>
+        free_space_solver = polygon_coverage_planning::createShortestPathSolver(
+            pwh, shortest_path_engine);
+    // Candidates are scored with the sweeps the plan uses. Manual directions
+    // are only entered for the chosen candidate, it is scored with automatic
+    // ones.
+    const Point_2 end(end_x, end_y);
+    const int best_candidate = selectDecompositionByPlan(
+        bcd_candidates, start, sweep_step, *free_space_solver, cost_model,
+        tune_sweep_directions && !manual_orientation,
+        select_sweep_variants && !manual_orientation, cell_order == 1,
+        tsp_time_budget, end_x >= 0 && end_y >= 0 ? &end : nullptr);
+    if (best_candidate < 0) {
+      std::cerr << "Cannot plan any candidate decomposition." << std::endl;
+      return EXIT_FAILURE;
+    }
+    bcd_cells = std::move(bcd_candidates[best_candidate]);
+    polygon_coverage_planning::computeCellAdjacency(bcd_cells,
+                                                    &cell_neighbors);
+  } else {
+    if (!polygon_coverage_planning::computeBestBCDFromPolygonWithHoles(
+            pwh, &bcd_cells, &cell_neighbors, nullptr)) {
+      std::cerr << "Cannot compute the cell decomposition." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (merge_cells) {
+      const size_t num_cells = bcd_cells.size();
+      polygon_coverage_planning::mergeCells(min_cell_area, min_cell_width,
+                                            &bcd_cells);
+      polygon_coverage_planning::computeCellAdjacency(
+          bcd_cells, &cell_neighbors);
+      std::cout << "Merged " << num_cells << " cells into " << bcd_cells.size()
+                << " cells." << std::endl;
+    }
+  }
 
   auto end_time = std::chrono::high_resolution_clock::now();
   auto execution_time = std::chrono::duration_cast<std::chrono::microseconds>(
@@ -406,21 +658,14 @@ int main() {
     cv::waitKey();
   }
 
-  auto cell_graph = calculateDecompositionAdjacency(bcd_cells);
-
-  // Get starting point from mouse click
-  Point_2 start;
-  if (mouse_select_start) {
-    std::cout << "Select starting point" << std::endl;
-    //start = getStartingPoint(original_img);
-    start = getStartingPoint(poly_canvas);
-  } else {
-    start = Point_2(start_x, start_y);
-    std::cout << "Starting point configured: (" << start.x() << ", " << start.y() << ")" << std::endl;
-  }
+  const CellAdjacency cell_adjacency =
+      calculateDecompositionAdjacency(cell_neighbors);
+  std::vector<CellNode> cell_graph(bcd_cells.size());
 
-  int starting_cell_idx = getCellIndexOfPoint(bcd_cells, start);
-  auto cell_idx_path = getTravellingPath(cell_graph, starting_cell_idx) ;
+  // Built once per plan, also answers progress queries of the robot
+  polygon_coverage_planning::CellLocator cell_locator(bcd_cells);
+  int starting_cell_idx = cell_locator.locateNearest(start);
+  auto cell_idx_path = getTravellingPath(cell_adjacency, starting_cell_idx) ;
   std::cout << "path length: " << cell_idx_path.size() << std::endl;
   std::cout << "start";
   for (auto &cell_idx : cell_idx_path) {
@@ -431,10 +676,56 @@ int main() {
   // sweep_step (distance per step in sweep),
   // int sweep_step = 5;
   std::vector<std::vector<Point_2>> cells_sweeps;
-  
-  if (manual_orientation) {
-    // Store user-defined angles for sweep direction
-    std::vector<double> polygon_sweep_directions;
+  // Congruent cells, e.g., identical aisles, share direction and sweep.
+  polygon_coverage_planning::SweepDirCache<K> sweep_dir_cache;
+  polygon_coverage_planning::SweepCache sweep_cache;
+  std::vector<Point_2> way_points;
+  const bool stream_plan = stream_waypoints && !manual_orientation;
+
+  if (stream_plan) {
+    // Hand out every cell as soon as it is planned, the robot can start
+    // while later cells are still computed. The waypoints are subdivided
+    // like the ones in WAYPOINT_COORDINATE_FILE_PATH.
+    std::ofstream out_stream(WAYPOINT_STREAM_FILE_PATH);
+    const int y_center = original_img.rows / 2;
+    bool has_last_point = false;
+    cv::Point last_point;
+    auto plan_start_time = std::chrono::high_resolution_clock::now();
+    way_points = streamCoveragePlan(
+        pwh, bcd_cells, cell_idx_path, start, sweep_step, shortest_path_engine,
+        &cells_sweeps,
+        [&](int cell_index, const std::vector<Point_2>& cell_way_points) {
+          for (const auto& way_point : cell_way_points) {
+            cv::Point point(std::round(CGAL::to_double(way_point.x())),
+                            std::round(CGAL::to_double(way_point.y())));
+            if (has_last_point) {
+              for (const auto& new_point : subdivideSegment(last_point, point)) {
+                out_stream << new_point.x << " " << (2 * y_center - new_point.y)
+                           << std::endl;
+              }
+            }
+            out_stream << point.x << " " << (2 * y_center - point.y)
+                       << std::endl;
+            last_point = point;
+            has_last_point = true;
+          }
+          std::chrono::duration<double> elapsed =
+              std::chrono::high_resolution_clock::now() - plan_start_time;
+          std::cout << "Emitted " << cell_way_points.size()
+                    << " waypoints of cell " << cell_index << " after "
+                    << elapsed.count() << "s" << std::endl;
+        });
+  } else if (manual_orientation) {
+    // Store user-defined angles for sweep direction, NaN if invalid
+    std::vector<double> polygon_sweep_directions(
+        bcd_cells.size(), std::numeric_limits<double>::quiet_NaN());
+
+    // Compute the best sweep directions of all cells before prompting
+    std::vector<Direction_2> best_sweep_dirs(bcd_cells.size());
+    polygon_coverage_planning::parallelFor(bcd_cells.size(), [&](size_t i) {
+      polygon_coverage_planning::findBestSweepDir(
+          bcd_cells[i], &sweep_dir_cache, &best_sweep_dirs[i]);
+    });
 
     // Create a named window to show the polygon
     cv::namedWindow("Selected Polygon", cv::WINDOW_NORMAL);
@@ -457,9 +748,8 @@ int main() {
       cv::imshow("Polygon Selection", img_copy);
       cv::waitKey(500);  // Allow the user to see the polygon
 
-      // Compute best sweep direction
-      Direction_2 best_sweep_dir;
-      double min_altitude = polygon_coverage_planning::findBestSweepDir(bcd_cells[i], &best_sweep_dir);
+      // Best sweep direction
+      const Direction_2& best_sweep_dir = best_sweep_dirs[i];
 
       // Ensure valid sweep direction
       if (std::isnan(CGAL::to_double(best_sweep_dir.dx())) || std::isnan(CGAL::to_double(best_sweep_dir.dy()))) {
@@ -491,178 +781,119 @@ int main() {
         user_angle = best_sweep_angle;  // Fallback to best sweep angle
       }
 
-      polygon_sweep_directions.push_back(user_angle);
+      polygon_sweep_directions[i] = user_angle;
     }
 
     // Execute sweep for each polygon using the user-defined or best direction
-    for (size_t i = 0; i < bcd_cells.size(); ++i) {
-      std::vector<Point_2> cell_sweep;
-
+    // Cells are swept in parallel and reported in order afterwards
+    cells_sweeps.resize(bcd_cells.size());
+    std::vector<std::string> sweep_errors(bcd_cells.size());
+    polygon_coverage_planning::parallelFor(bcd_cells.size(), [&](size_t i) {
       // Convert the user-defined angle to radians
       double angle_in_radians = polygon_sweep_directions[i] * (M_PI / 180.0);
 
       // Ensure valid direction vectors
       if (std::isnan(std::cos(angle_in_radians)) || std::isnan(std::sin(angle_in_radians))) {
-        std::cerr << "Invalid sweep direction for polygon " << i << ". Using default direction." << std::endl;
-        continue;  // Skip this polygon if the direction is invalid
+        sweep_errors[i] = "Invalid sweep direction for polygon " + std::to_string(i) + ". Skipping it.";
+        return;  // Skip this polygon if the direction is invalid
       }
 
       // Create direction from the angle
       Direction_2 user_defined_dir(std::cos(angle_in_radians), std::sin(angle_in_radians));
 
       // Perform sweep using the user-defined direction
-      polygon_coverage_planning::visibility_graph::VisibilityGraph vis_graph(bcd_cells[i]);
-
       try {
-        polygon_coverage_planning::computeSweep(bcd_cells[i], vis_graph, sweep_step, user_defined_dir, true, &cell_sweep);
+        std::unique_ptr<polygon_coverage_planning::ShortestPathSolver> solver =
+            polygon_coverage_planning::createShortestPathSolver(bcd_cells[i]);
+        polygon_coverage_planning::computeSweep(bcd_cells[i], *solver, sweep_step, user_defined_dir, true, &cells_sweeps[i]);
+      } catch (const std::exception& e) {
+        sweep_errors[i] = "Error constructing sweep for polygon " + std::to_string(i + 1) + ": " + e.what();
+      }
+    });
 
-        if (cell_sweep.empty()) {
-            std::cerr << "Warning: Sweep for polygon " << i + 1 << " returned no points." << std::endl;
-        } else {
-            std::cout << "Successfully constructed sweep for polygon " << i + 1 << std::endl;
+    for (size_t i = 0; i < bcd_cells.size(); ++i) {
+      if (!sweep_errors[i].empty()) {
+        std::cerr << sweep_errors[i] << std::endl;
+      } else if (cells_sweeps[i].empty()) {
+        std::cerr << "Warning: Sweep for polygon " << i + 1 << " returned no points." << std::endl;
+      } else {
+        std::cout << "Successfully constructed sweep for polygon " << i + 1 << std::endl;
+      }
+    }
+  } else if (tune_sweep_directions) {
+    // Try all sweepable directions of every cell, all cells and directions
+    // are swept in one parallel loop
+    if (!computeTunedSweeps(bcd_cells, sweep_step, cost_model, &cells_sweeps)) {
+      for (size_t i = 0; i < bcd_cells.size(); ++i) {
+        if (cells_sweeps[i].empty()) {
+          std::cerr << "Cannot compute sweep for polygon " << i << std::endl;
         }
-
-        cells_sweeps.emplace_back(cell_sweep);
-
-      } catch (const std::exception& e) {
-        std::cerr << "Error constructing sweep for polygon " << i + 1 << ": " << e.what() << std::endl;
       }
     }
   } else {
-    for (size_t i = 0; i < bcd_cells.size(); ++i) {
-      // Compute all cluster sweeps.
-      std::vector<Point_2> cell_sweep;
+    // Cells are swept in parallel, congruent cells reuse direction and sweep
+    cells_sweeps.resize(bcd_cells.size());
+    polygon_coverage_planning::parallelFor(bcd_cells.size(), [&](size_t i) {
       Direction_2 best_dir;
-      polygon_coverage_planning::findBestSweepDir(bcd_cells[i], &best_dir);
-      polygon_coverage_planning::visibility_graph::VisibilityGraph vis_graph(
-          bcd_cells[i]);
+      polygon_coverage_planning::findBestSweepDir(bcd_cells[i],
+                                                  &sweep_dir_cache, &best_dir);
 
       bool counter_clockwise = true;
-      polygon_coverage_planning::computeSweep(bcd_cells[i], vis_graph, sweep_step,
+      polygon_coverage_planning::computeSweep(bcd_cells[i], sweep_step,
                                               best_dir, counter_clockwise,
-                                              &cell_sweep);
-      cells_sweeps.emplace_back(cell_sweep);
-    }
+                                              &sweep_cache, &cells_sweeps[i]);
+    });
+    std::cout << "Reused the sweeps of " << sweep_cache.getNumHits()
+              << " congruent cells." << std::endl;
   }
 
-  auto cell_intersections = calculateCellIntersections(bcd_cells, cell_graph);
-
-  std::vector<Point_2> way_points;
-
 #ifdef DENSE_PATH
-  Point_2 point = start;
-  std::list<Point_2> next_candidates;
-  Point_2 next_point;
-  std::vector<Point_2> shortest_path;
-
-  if (doReverseNextSweep(start, cells_sweeps[cell_idx_path.front()])) {
-    shortest_path = getShortestPath(bcd_cells[cell_idx_path.front()], start,
-                                    cells_sweeps[cell_idx_path.front()].back());
-    way_points.insert(way_points.end(), shortest_path.begin(),
-                      std::prev(shortest_path.end()));
-  } else {
-    shortest_path =
-        getShortestPath(bcd_cells[cell_idx_path.front()], start,
-                        cells_sweeps[cell_idx_path.front()].front());
-    way_points.insert(way_points.end(), shortest_path.begin(),
-                      std::prev(shortest_path.end()));
-  }
-
-  point = way_points.back();
-
-  for (size_t i = 0; i < cell_idx_path.size(); ++i) {
-    // has been cleaned?
-    if (!cell_graph[cell_idx_path[i]].isCleaned) {
-      // need to reverse?
-      if (doReverseNextSweep(point, cells_sweeps[cell_idx_path[i]])) {
-        way_points.insert(way_points.end(),
-                          cells_sweeps[cell_idx_path[i]].rbegin(),
-                          cells_sweeps[cell_idx_path[i]].rend());
-      } else {
-        way_points.insert(way_points.end(),
-                          cells_sweeps[cell_idx_path[i]].begin(),
-                          cells_sweeps[cell_idx_path[i]].end());
+  if (!stream_plan) {
+    // Transitions are geodesics through the whole free space. Cleaned cells on
+    // the way back to the next uncleaned cell are simply passed through.
+    std::unique_ptr<polygon_coverage_planning::ShortestPathSolver>
+        free_space_solver = polygon_coverage_planning::createShortestPathSolver(
+            pwh, shortest_path_engine);
+    if (cell_order == 1) {
+      // The TSP costs are free space paths between the sweeps, so the order
+      // is only fixed after sweeping
+      int end_cell_idx = -1;
+      if (end_x >= 0 && end_y >= 0) {
+        end_cell_idx = cell_locator.locateNearest(Point_2(end_x, end_y));
       }
-      // now cleaned
-      cell_graph[cell_idx_path[i]].isCleaned = true;
-      // update current point
-      point = way_points.back();
-      // find shortest path to next cell
-      if ((i + 1) < cell_idx_path.size()) {
-        next_candidates =
-            cell_intersections[cell_idx_path[i]][cell_idx_path[i + 1]];
-        if (doReverseNextSweep(point, cells_sweeps[cell_idx_path[i + 1]])) {
-          next_point =
-              findNextGoal(point, cells_sweeps[cell_idx_path[i + 1]].back(),
-                           next_candidates);
-          shortest_path =
-              getShortestPath(bcd_cells[cell_idx_path[i]], point, next_point);
-          way_points.insert(way_points.end(), std::next(shortest_path.begin()),
-                            std::prev(shortest_path.end()));
-          shortest_path =
-              getShortestPath(bcd_cells[cell_idx_path[i + 1]], next_point,
-                              cells_sweeps[cell_idx_path[i + 1]].back());
-        } else {
-          next_point =
-              findNextGoal(point, cells_sweeps[cell_idx_path[i + 1]].front(),
-                           next_candidates);
-          shortest_path =
-              getShortestPath(bcd_cells[cell_idx_path[i]], point, next_point);
-          way_points.insert(way_points.end(), std::next(shortest_path.begin()),
-                            std::prev(shortest_path.end()));
-          shortest_path =
-              getShortestPath(bcd_cells[cell_idx_path[i + 1]], next_point,
-                              cells_sweeps[cell_idx_path[i + 1]].front());
-        }
-        way_points.insert(way_points.end(), shortest_path.begin(),
-                          std::prev(shortest_path.end()));
-        point = way_points.back();
+      CellOrderCosts order_costs;
+      cell_idx_path = getTspTravellingPath(
+          cells_sweeps, *free_space_solver, cost_model, cell_idx_path,
+          starting_cell_idx, end_cell_idx, tsp_time_budget, &order_costs);
+      if (order_costs.solved) {
+        std::cout << "TSP cell order cost: " << order_costs.tsp
+                  << " (DFS: " << order_costs.dfs << ")" << std::endl;
       }
-    } else {
-      shortest_path = getShortestPath(bcd_cells[cell_idx_path[i]],
-                                      cells_sweeps[cell_idx_path[i]].front(),
-                                      cells_sweeps[cell_idx_path[i]].back());
-      if (doReverseNextSweep(point, cells_sweeps[cell_idx_path[i]])) {
-        way_points.insert(way_points.end(), shortest_path.rbegin(),
-                          shortest_path.rend());
-      } else {
-        way_points.insert(way_points.end(), shortest_path.begin(),
-                          shortest_path.end());
-      }
-      point = way_points.back();
-
-      if ((i + 1) < cell_idx_path.size()) {
-        next_candidates =
-            cell_intersections[cell_idx_path[i]][cell_idx_path[i + 1]];
-        if (doReverseNextSweep(point, cells_sweeps[cell_idx_path[i + 1]])) {
-          next_point =
-              findNextGoal(point, cells_sweeps[cell_idx_path[i + 1]].back(),
-                           next_candidates);
-          shortest_path =
-              getShortestPath(bcd_cells[cell_idx_path[i]], point, next_point);
-          way_points.insert(way_points.end(), std::next(shortest_path.begin()),
-                            std::prev(shortest_path.end()));
-          shortest_path =
-              getShortestPath(bcd_cells[cell_idx_path[i + 1]], next_point,
-                              cells_sweeps[cell_idx_path[i + 1]].back());
-        } else {
-          next_point =
-              findNextGoal(point, cells_sweeps[cell_idx_path[i + 1]].front(),
-                           next_candidates);
-          shortest_path =
-              getShortestPath(bcd_cells[cell_idx_path[i]], point, next_point);
-          way_points.insert(way_points.end(), std::next(shortest_path.begin()),
-                            std::prev(shortest_path.end()));
-          shortest_path =
-              getShortestPath(bcd_cells[cell_idx_path[i + 1]], next_point,
-                              cells_sweeps[cell_idx_path[i + 1]].front());
-        }
-        way_points.insert(way_points.end(), shortest_path.begin(),
-                          std::prev(shortest_path.end()));
-        point = way_points.back();
+      std::cout << "TSP order: start";
+      for (auto &cell_idx : cell_idx_path) {
+        std::cout << "->" << cell_idx;
       }
+      std::cout << std::endl;
+    }
+    // Fix all sweep orientations first, then compute the independent
+    // transitions in parallel and concatenate them.
+    std::vector<CellVisit> visits =
+        select_sweep_variants && !manual_orientation
+            ? selectSweepVariants(start, cell_idx_path, bcd_cells, sweep_step,
+                                  *free_space_solver, cost_model, cell_graph,
+                                  &cells_sweeps)
+            : resolveCellVisits(start, cell_idx_path, cell_graph, cells_sweeps);
+    std::vector<std::vector<Point_2>> transitions(visits.size());
+    polygon_coverage_planning::parallelFor(visits.size(), [&](size_t k) {
+      transitions[k] = getShortestPath(*free_space_solver, visits[k].from,
+                                       visits[k].entry);
+    });
+    for (size_t k = 0; k < visits.size(); ++k) {
+      appendCellVisit(visits[k], transitions[k], cells_sweeps, &way_points);
     }
   }
+  std::cout << "Estimated execution time: "
+            << cost_model.computeCost(way_points) << "s" << std::endl;
 
   cv::Point p1, p2;
   cv::namedWindow("cover", cv::WINDOW_NORMAL);
@@ -685,39 +916,18 @@ for (size_t i = 1; i < way_points.size(); ++i) {
         continue;  // Skip this iteration if invalid points are found
     }
 
-    std::vector<cv::Point> newPoints;
-
-    // get number of subdivisions
-    if (subdivision_dist > 0) {
-      double euclidean_dist = std::sqrt(std::pow(p2.x - p1.x, 2) + std::pow(p2.y - p1.y, 2));
-      // std::cout << "euclidean_dist: " << euclidean_dist << std::endl;
-      double number_of_subdivisions = std::round(euclidean_dist / subdivision_dist);
-      // std::cout << "# of subdivisions: " << number_of_subdivisions << std::endl;
-
-
-      if (number_of_subdivisions > 0) {
-        // Compute the step increments based on the number of subdivisions
-        double stepX = (p2.x - p1.x) / static_cast<double>(number_of_subdivisions + 1);
-        double stepY = (p2.y - p1.y) / static_cast<double>(number_of_subdivisions + 1);
-
-        // Add intermediate points
-        for (int i = 1; i <= number_of_subdivisions; ++i) {
-            cv::Point intermediatePoint;
-            intermediatePoint.x = std::round(p1.x + stepX * i);
-            intermediatePoint.y = std::round(p1.y + stepY * i);
-            newPoints.push_back(intermediatePoint);
-        }
+    std::vector<cv::Point> newPoints = subdivideSegment(p1, p2);
 
+    if (!newPoints.empty()) {
         // Draw the initial line segment from p1 to the first interpolated point
         cv::line(original_img, p1, newPoints[0], cv::Scalar(0, 64, 255));
         for (size_t j = 0; j < newPoints.size() - 1; ++j) {
             cv::line(original_img, newPoints[j], newPoints[j + 1], cv::Scalar(0, 64, 255));  // Draw between subdivided points
         }
         cv::line(original_img, newPoints.back(), p2, cv::Scalar(0, 64, 255));  // Draw final segment to p2
-      } else {
+    } else if (subdivision_dist > 0) {
         // If subdivisions == 0, directly draw the line between p1 and p2
           cv::line(original_img, p1, p2, cv::Scalar(0, 64, 255));
-      }
     }
 
     cv::namedWindow("cover", cv::WINDOW_NORMAL);
@@ -752,6 +962,7 @@ for (size_t i = 1; i < way_points.size(); ++i) {
   cv::waitKey();
 
   Point_2 point = start;
+  way_points.clear();
   way_points.emplace_back(point);
 
   for (auto &idx : cell_idx_path) {
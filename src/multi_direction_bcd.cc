@@ -0,0 +1,161 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CGAL/Cartesian_converter.h>
+
+#include "bcd.h"
+#include "cgal_comm.h"
+#include "decomposition.h"
+#include "multi_direction_bcd.h"
+
+namespace polygon_coverage_planning {
+
+namespace {
+
+InexactPolygon_2 toInexact(const Polygon_2 &polygon) {
+  CGAL::Cartesian_converter<K, InexactKernel> to_inexact;
+  InexactPolygon_2 inexact_polygon;
+  for (VertexConstIterator vit = polygon.vertices_begin();
+       vit != polygon.vertices_end(); ++vit)
+    inexact_polygon.push_back(to_inexact(*vit));
+  return inexact_polygon;
+}
+
+// Same as rotatePolygon with double coordinates.
+InexactPolygonWithHoles rotateInexact(const InexactPolygonWithHoles &polygon,
+                                      const InexactKernel::Direction_2 &dir) {
+  CGAL::Aff_transformation_2<InexactKernel> rotation(CGAL::ROTATION, dir, 1,
+                                                     1e9);
+  rotation = rotation.inverse();
+  InexactPolygonWithHoles rotated_polygon(
+      CGAL::transform(rotation, polygon.outer_boundary()));
+  for (auto hit = polygon.holes_begin(); hit != polygon.holes_end(); ++hit)
+    rotated_polygon.add_hole(CGAL::transform(rotation, *hit));
+  return rotated_polygon;
+}
+
+// Rounding can merge, flip or align vertices of the rotated polygon. The sweep
+// requires simple rings with the orientation of sortPolygon and no collinear
+// vertices as left by simplifyPolygon.
+bool isValidRing(const InexactPolygon_2 &ring, CGAL::Orientation orientation) {
+  if (ring.size() < 3 || !ring.is_simple() ||
+      ring.orientation() != orientation)
+    return false;
+  InexactPolygon_2::Vertex_const_circulator v = ring.vertices_circulator();
+  do {
+    if (CGAL::collinear(*std::prev(v), *v, *std::next(v)))
+      return false;
+  } while (++v != ring.vertices_circulator());
+  return true;
+}
+
+bool isValidRotation(const InexactPolygonWithHoles &rotated_polygon) {
+  if (!isValidRing(rotated_polygon.outer_boundary(), CGAL::COUNTERCLOCKWISE))
+    return false;
+  for (auto hit = rotated_polygon.holes_begin();
+       hit != rotated_polygon.holes_end(); ++hit) {
+    if (!isValidRing(*hit, CGAL::CLOCKWISE))
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+MultiDirectionBCD::MultiDirectionBCD(const PolygonWithHoles &pwh)
+    : polygon_(pwh), directions_(findUniquePerpEdgeDirections(pwh)) {
+  // Rotations preserve orientation and collinearity, so every rotated copy of
+  // the polygon stays sorted and simplified.
+  sortPolygon(&polygon_);
+  simplifyPolygon(&polygon_);
+
+  inexact_polygon_ =
+      InexactPolygonWithHoles(toInexact(polygon_.outer_boundary()));
+  for (PolygonWithHoles::Hole_const_iterator hit = polygon_.holes_begin();
+       hit != polygon_.holes_end(); ++hit)
+    inexact_polygon_.add_hole(toInexact(*hit));
+}
+
+double MultiDirectionBCD::evaluate(size_t begin, size_t end,
+                                   size_t num_slabs,
+                                   std::vector<Polygon_2> *best_cells,
+                                   Direction_2 *best_dir) const {
+  double min_altitude_sum = std::numeric_limits<double>::max();
+  // Congruent cells, e.g., rack aisles, are scored once.
+  SweepDirCache<K> sweep_dir_cache;
+
+  for (size_t i = begin; i < end && i < directions_.size(); ++i) {
+    const Direction_2 &dir = directions_[i];
+    PolygonWithHoles rotated_polygon = rotatePolygon(polygon_, dir);
+
+    std::vector<Polygon_2> cells =
+        num_slabs > 1 ? computeSlabBCD(rotated_polygon, num_slabs)
+                      : computeRotatedBCD(rotated_polygon);
+
+    // Rotate back all polygons.
+    CGAL::Aff_transformation_2<K> rotation(CGAL::ROTATION, dir, 1, 1e9);
+    double altitude_sum = 0.0;
+    for (Polygon_2 &cell : cells) {
+      cell = CGAL::transform(rotation, cell);
+      altitude_sum += findBestSweepDir(cell, &sweep_dir_cache);
+    }
+
+    if (altitude_sum < min_altitude_sum) {
+      min_altitude_sum = altitude_sum;
+      *best_cells = std::move(cells);
+      if (best_dir)
+        *best_dir = dir;
+    }
+  }
+
+  return min_altitude_sum;
+}
+
+void MultiDirectionBCD::estimate(size_t begin, size_t end,
+                                 std::vector<double> *scores) const {
+  SweepDirCache<InexactKernel> sweep_dir_cache;
+  for (size_t i = begin; i < end && i < directions_.size(); ++i) {
+    const InexactKernel::Direction_2 dir(CGAL::to_double(directions_[i].dx()),
+                                         CGAL::to_double(directions_[i].dy()));
+    // Release builds do not check CGAL preconditions, so invalid rotations
+    // are rejected explicitly. Such directions are left to the exact
+    // decomposition.
+    InexactPolygonWithHoles rotated_polygon =
+        rotateInexact(inexact_polygon_, dir);
+    if (!isValidRotation(rotated_polygon)) {
+      (*scores)[i] = -1.0;
+      continue;
+    }
+    try {
+      std::vector<InexactPolygon_2> cells = computeRotatedBCD(rotated_polygon);
+
+      // Altitudes do not depend on the rotation, so the cells are not rotated
+      // back.
+      double altitude_sum = 0.0;
+      for (const InexactPolygon_2 &cell : cells)
+        altitude_sum += findBestSweepDir(cell, &sweep_dir_cache);
+      (*scores)[i] = altitude_sum;
+    } catch (const std::exception &) {
+      // Debug builds also throw on violated CGAL preconditions.
+      (*scores)[i] = -1.0;
+    }
+  }
+}
+
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,188 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cgal_comm.h"
+#include "navigation_mesh.h"
+
+namespace polygon_coverage_planning {
+namespace navigation_mesh {
+
+namespace {
+
+double computeEuclideanSegmentCost(const Point_2& from, const Point_2& to) {
+  return std::sqrt(CGAL::to_double(CGAL::squared_distance(from, to)));
+}
+
+}  // namespace
+
+NavigationMesh::NavigationMesh(const PolygonWithHoles& polygon)
+    : GraphBase(), polygon_(polygon) {
+  // Build navigation mesh.
+  is_created_ = create();
+}
+
+bool NavigationMesh::create() {
+  clear();
+  std::vector<FaceHandle> faces;
+  triangulatePolygon(polygon_, &cdt_, &faces);
+  if (faces.empty()) {
+    std::cout << "Cannot triangulate polygon." << std::endl;
+    return false;
+  }
+
+  // Face ids and node ids coincide.
+  reserve(faces.size());
+  for (const FaceHandle& face : faces) {
+    const Point_2 center = CGAL::centroid(face->vertex(0)->point(),
+                                          face->vertex(1)->point(),
+                                          face->vertex(2)->point());
+    if (!addNode(NodeProperty(face, center))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool NavigationMesh::addEdges() {
+  if (graph_.empty()) {
+    std::cout << "Cannot add edges to an empty graph." << std::endl;
+    return false;
+  }
+
+  const size_t new_id = graph_.size() - 1;
+  const NodeProperty* new_node_property = getNodeProperty(new_id);
+  for (int i = 0; i < 3; ++i) {
+    const FaceHandle& face = new_node_property->face;
+    const FaceHandle adj_face = face->neighbor(i);
+    if (cdt_.is_constrained(CDT::Edge(face, i)) ||
+        cdt_.is_infinite(adj_face) || !adj_face->info().inDomain())
+      continue;
+    const size_t adj_id = static_cast<size_t>(adj_face->info().id);
+    // The adjacent triangle adds the edge once it is added itself.
+    if (adj_id >= new_id)
+      continue;
+    const NodeProperty* adj_node_property = getNodeProperty(adj_id);
+    if (adj_node_property == nullptr) {
+      std::cout << "Cannot access potential neighbor." << std::endl;
+      return false;
+    }
+
+    Portal forwards_portal;
+    getPortal(face, adj_face, &forwards_portal.first,
+              &forwards_portal.second);
+    const Portal backwards_portal(forwards_portal.second,
+                                  forwards_portal.first);
+    const double cost = computeEuclideanSegmentCost(
+        new_node_property->center,
+        adj_node_property->center);  // Symmetric cost.
+    if (!addEdge(EdgeId(new_id, adj_id), EdgeProperty(forwards_portal),
+                 cost) ||
+        !addEdge(EdgeId(adj_id, new_id), EdgeProperty(backwards_portal),
+                 cost)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NavigationMesh::solve(const Point_2& start, const Point_2& goal,
+                           std::vector<Point_2>* waypoints) const {
+  waypoints->clear();
+
+  if (!is_created_) {
+    std::cout << "Navigation mesh not initialized." << std::endl;
+    return false;
+  }
+
+  // Make sure start and end are inside the polygon.
+  const Point_2 start_new = pointInPolygon(polygon_, start)
+                                ? start
+                                : projectPointOnHull(polygon_, start);
+  const Point_2 goal_new = pointInPolygon(polygon_, goal)
+                               ? goal
+                               : projectPointOnHull(polygon_, goal);
+
+  FaceHandle start_face, goal_face;
+  std::unique_lock<std::mutex> lock(locate_mutex_);
+  const bool located = locateFace(cdt_, start_new, &start_face) &&
+                       locateFace(cdt_, goal_new, &goal_face);
+  lock.unlock();
+  if (!located) {
+    std::cout << "Cannot locate start or goal in navigation mesh." << std::endl;
+    return false;
+  }
+
+  // Find the channel using A*.
+  Solution solution;
+  if (!solveAStar(static_cast<size_t>(start_face->info().id),
+                  static_cast<size_t>(goal_face->info().id), &solution)) {
+    std::cout << "Could not find shortest path. Graph not fully connected."
+              << std::endl;
+    return false;
+  }
+
+  std::vector<Portal> portals;
+  portals.reserve(solution.size() + 1);
+  portals.push_back(std::make_pair(start_new, start_new));
+  for (size_t i = 0; i + 1 < solution.size(); ++i) {
+    const EdgeProperty* edge_property =
+        getEdgeProperty(EdgeId(solution[i], solution[i + 1]));
+    if (edge_property == nullptr) {
+      std::cout << "Cannot reconstruct solution." << std::endl;
+      return false;
+    }
+    portals.push_back(edge_property->portal);
+  }
+  portals.push_back(std::make_pair(goal_new, goal_new));
+
+  pullString(portals, waypoints);
+  if (waypoints->size() == 1)
+    waypoints->push_back(goal_new);
+  return true;
+}
+
+bool NavigationMesh::calculateHeuristic(size_t goal,
+                                        Heuristic* heuristic) const {
+  heuristic->clear();
+
+  const NodeProperty* goal_node_property = getNodeProperty(goal);
+  if (goal_node_property == nullptr) {
+    std::cout << "Cannot find goal node property to calculate heuristic."
+              << std::endl;
+    return false;
+  }
+
+  for (size_t adj_id = 0; adj_id < graph_.size(); ++adj_id) {
+    const NodeProperty* adj_node_property = getNodeProperty(adj_id);
+    if (adj_node_property == nullptr) {
+      std::cout
+          << "Cannot access adjacent node property to calculate heuristic."
+          << std::endl;
+      return false;
+    }
+    (*heuristic)[adj_id] = computeEuclideanSegmentCost(
+        adj_node_property->center, goal_node_property->center);
+  }
+
+  return true;
+}
+
+}  // namespace navigation_mesh
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,380 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+#include "polygon_simplification.h"
+
+namespace polygon_coverage_planning {
+
+namespace {
+
+struct Point {
+  double x;
+  double y;
+};
+
+int orientation(const Point& a, const Point& b, const Point& c) {
+  const double v = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+  return (v > 0.0) - (v < 0.0);
+}
+
+// Whether p, collinear with a and b, lies on segment ab.
+bool onSegment(const Point& a, const Point& b, const Point& p) {
+  return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) &&
+         std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+}
+
+bool segmentsIntersect(const Point& a, const Point& b, const Point& c,
+                       const Point& d) {
+  const int o1 = orientation(a, b, c), o2 = orientation(a, b, d);
+  const int o3 = orientation(c, d, a), o4 = orientation(c, d, b);
+  if (o1 != o2 && o3 != o4) return true;
+  return (o1 == 0 && onSegment(a, b, c)) || (o2 == 0 && onSegment(a, b, d)) ||
+         (o3 == 0 && onSegment(c, d, a)) || (o4 == 0 && onSegment(c, d, b));
+}
+
+// Whether q lies inside or on the triangle abc.
+bool inTriangle(const Point& a, const Point& b, const Point& c,
+                const Point& q) {
+  if (orientation(a, b, c) == 0) {
+    // Degenerate, q needs to lie on the segment spanned by a, b and c.
+    const bool on_line = orientation(a, b, q) == 0 &&
+                         orientation(b, c, q) == 0 &&
+                         orientation(c, a, q) == 0;
+    return on_line && std::min({a.x, b.x, c.x}) <= q.x &&
+           q.x <= std::max({a.x, b.x, c.x}) &&
+           std::min({a.y, b.y, c.y}) <= q.y &&
+           q.y <= std::max({a.y, b.y, c.y});
+  }
+  const int o1 = orientation(a, b, q), o2 = orientation(b, c, q);
+  const int o3 = orientation(c, a, q);
+  const bool has_neg = o1 < 0 || o2 < 0 || o3 < 0;
+  const bool has_pos = o1 > 0 || o2 > 0 || o3 > 0;
+  return !(has_neg && has_pos);
+}
+
+double distanceToSegment(const Point& p, const Point& a, const Point& b) {
+  const double dx = b.x - a.x, dy = b.y - a.y;
+  const double sq_length = dx * dx + dy * dy;
+  double t = 0.0;
+  if (sq_length > 0.0)
+    t = std::max(0.0, std::min(1.0, ((p.x - a.x) * dx + (p.y - a.y) * dy) /
+                                        sq_length));
+  return std::hypot(p.x - a.x - t * dx, p.y - a.y - t * dy);
+}
+
+// All rings as doubly linked vertex lists. The edges, identified by their
+// source vertex, are indexed in a uniform grid to test shortcuts locally.
+class RingSimplifier {
+ public:
+  RingSimplifier(const std::vector<Polygon_2>& rings) {
+    for (size_t r = 0; r < rings.size(); ++r) {
+      const int begin = points_.size();
+      for (const Point_2& p : rings[r].container()) {
+        // Repeated vertices would be zero length edges.
+        if (static_cast<int>(exact_.size()) > begin &&
+            (p == exact_.back() || p == exact_[begin]))
+          continue;
+        exact_.push_back(p);
+        points_.push_back({CGAL::to_double(p.x()), CGAL::to_double(p.y())});
+        ring_.push_back(r);
+      }
+      const int end = points_.size();
+      ring_begin_.push_back(begin);
+      ring_end_.push_back(end);
+      ring_size_.push_back(end - begin);
+      for (int i = begin; i < end; ++i) {
+        prev_.push_back(i == begin ? end - 1 : i - 1);
+        next_.push_back(i + 1 == end ? begin : i + 1);
+      }
+    }
+    alive_.assign(points_.size(), true);
+    version_.assign(points_.size(), 0);
+    stamp_.assign(points_.size(), 0);
+
+    // About one bucket per vertex.
+    double x_max = 0.0, y_max = 0.0;
+    x_min_ = y_min_ = 0.0;
+    if (!points_.empty()) {
+      x_min_ = x_max = points_.front().x;
+      y_min_ = y_max = points_.front().y;
+    }
+    for (const Point& p : points_) {
+      x_min_ = std::min(x_min_, p.x);
+      x_max = std::max(x_max, p.x);
+      y_min_ = std::min(y_min_, p.y);
+      y_max = std::max(y_max, p.y);
+    }
+    const double num_points = std::max<size_t>(1, points_.size());
+    bucket_size_ = std::max(
+        {std::sqrt((x_max - x_min_) * (y_max - y_min_) / num_points),
+         std::max(x_max - x_min_, y_max - y_min_) / num_points, 1e-9});
+    cols_ = static_cast<int>((x_max - x_min_) / bucket_size_) + 1;
+    rows_ = static_cast<int>((y_max - y_min_) / bucket_size_) + 1;
+    buckets_.resize(cols_ * rows_);
+    for (size_t i = 0; i < points_.size(); ++i) insertEdge(i);
+  }
+
+  size_t simplify(double tolerance, size_t max_vertices) {
+    typedef std::tuple<double, int, int> Candidate;  // Error, vertex, version.
+    std::priority_queue<Candidate, std::vector<Candidate>,
+                        std::greater<Candidate>>
+        candidates;
+    auto push = [&](int v) {
+      if (ring_size_[ring_[v]] > 3)
+        candidates.emplace(computeError(v), v, version_[v]);
+    };
+    for (size_t v = 0; v < points_.size(); ++v) push(v);
+
+    size_t num_vertices = points_.size();
+    size_t num_removed = 0;
+    while (!candidates.empty()) {
+      const Candidate candidate = candidates.top();
+      candidates.pop();
+      const int v = std::get<1>(candidate);
+      if (!alive_[v] || std::get<2>(candidate) != version_[v]) continue;
+      if (std::get<0>(candidate) > tolerance &&
+          (max_vertices == 0 || num_vertices <= max_vertices))
+        break;
+      // Rejected vertices are retried once a neighbor changes.
+      if (ring_size_[ring_[v]] <= 3 || !isValidShortcut(v)) continue;
+
+      const int p = prev_[v], n = next_[v];
+      next_[p] = n;
+      prev_[n] = p;
+      alive_[v] = false;
+      --ring_size_[ring_[v]];
+      --num_vertices;
+      ++num_removed;
+      insertEdge(p);
+      ++version_[p];
+      ++version_[n];
+      push(p);
+      push(n);
+    }
+    return num_removed;
+  }
+
+  void getRings(std::vector<Polygon_2>* rings) const {
+    rings->clear();
+    for (size_t r = 0; r < ring_begin_.size(); ++r) {
+      if (ring_begin_[r] == ring_end_[r]) {
+        rings->push_back(Polygon_2());
+        continue;
+      }
+      int start = ring_begin_[r];
+      while (!alive_[start]) ++start;
+      Polygon_2 ring;
+      int v = start;
+      do {
+        ring.push_back(exact_[v]);
+        v = next_[v];
+      } while (v != start);
+      rings->push_back(ring);
+    }
+  }
+
+ private:
+  // Largest distance of the original vertices between the neighbors of v to
+  // the shortcut.
+  double computeError(int v) const {
+    const int p = prev_[v], n = next_[v];
+    const int r = ring_[v];
+    double error = 0.0;
+    for (int i = p;;) {
+      i = i + 1 == ring_end_[r] ? ring_begin_[r] : i + 1;
+      if (i == n) break;
+      error = std::max(error, distanceToSegment(points_[i], points_[p],
+                                                points_[n]));
+    }
+    return error;
+  }
+
+  // The shortcut from prev to next of v must not touch other edges, and the
+  // cut off triangle must not contain other vertices.
+  bool isValidShortcut(int v) {
+    const int p = prev_[v], n = next_[v];
+    const Point& a = points_[p];
+    const Point& b = points_[n];
+    const Point& c = points_[v];
+    ++query_;
+    bool valid = true;
+    forEachBucket(std::min({a.x, b.x, c.x}), std::min({a.y, b.y, c.y}),
+                  std::max({a.x, b.x, c.x}), std::max({a.y, b.y, c.y}),
+                  [&](const std::vector<std::pair<int, int>>& bucket) {
+      for (const auto& edge : bucket) {
+        const int s = edge.first, t = edge.second;
+        if (!valid) return;
+        if (!alive_[s] || next_[s] != t || stamp_[s] == query_) continue;
+        stamp_[s] = query_;
+        if (s == p || s == v) continue;  // Edges that are replaced.
+
+        if (s != n && inTriangle(a, c, b, points_[s])) {
+          valid = false;
+        } else if (s == n || t == p) {
+          // Adjacent edge, must not fold back onto the shortcut.
+          const Point& o = s == n ? points_[t] : points_[s];
+          const Point& from = s == n ? b : a;
+          const Point& to = s == n ? a : b;
+          valid = orientation(from, to, o) != 0 ||
+                  (o.x - from.x) * (to.x - from.x) +
+                          (o.y - from.y) * (to.y - from.y) <=
+                      0.0;
+        } else {
+          valid = !segmentsIntersect(a, b, points_[s], points_[t]);
+        }
+      }
+    });
+    return valid;
+  }
+
+  void insertEdge(int s) {
+    const Point& a = points_[s];
+    const Point& b = points_[next_[s]];
+    const int t = next_[s];
+    forEachBucket(std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.x, b.x),
+                  std::max(a.y, b.y),
+                  [s, t](std::vector<std::pair<int, int>>& bucket) {
+                    bucket.emplace_back(s, t);
+                  });
+  }
+
+  template <class Function>
+  void forEachBucket(double x_min, double y_min, double x_max, double y_max,
+                     const Function& f) {
+    auto toCol = [this](double x) {
+      return std::min(std::max(static_cast<int>((x - x_min_) / bucket_size_),
+                               0),
+                      cols_ - 1);
+    };
+    auto toRow = [this](double y) {
+      return std::min(std::max(static_cast<int>((y - y_min_) / bucket_size_),
+                               0),
+                      rows_ - 1);
+    };
+    for (int row = toRow(y_min); row <= toRow(y_max); ++row)
+      for (int col = toCol(x_min); col <= toCol(x_max); ++col)
+        f(buckets_[row * cols_ + col]);
+  }
+
+  std::vector<Point> points_;
+  std::vector<Point_2> exact_;
+  std::vector<int> ring_;
+  std::vector<int> ring_begin_;
+  std::vector<int> ring_end_;
+  std::vector<int> ring_size_;
+  std::vector<int> prev_;
+  std::vector<int> next_;
+  std::vector<bool> alive_;
+  std::vector<int> version_;
+  std::vector<int> stamp_;
+  int query_ = 0;
+
+  double x_min_;
+  double y_min_;
+  double bucket_size_;
+  int cols_;
+  int rows_;
+  std::vector<std::vector<std::pair<int, int>>> buckets_;
+};
+
+bool edgesIntersect(const Polygon_2& a, const Polygon_2& b) {
+  if (!CGAL::do_overlap(a.bbox(), b.bbox())) return false;
+  for (auto ea = a.edges_begin(); ea != a.edges_end(); ++ea)
+    for (auto eb = b.edges_begin(); eb != b.edges_end(); ++eb)
+      if (CGAL::do_overlap(ea->bbox(), eb->bbox()) &&
+          CGAL::do_intersect(*ea, *eb))
+        return true;
+  return false;
+}
+
+}  // namespace
+
+size_t simplifyRings(double tolerance, size_t max_vertices,
+                     std::vector<Polygon_2>* rings) {
+  RingSimplifier simplifier(*rings);
+  const size_t num_removed = simplifier.simplify(tolerance, max_vertices);
+  simplifier.getRings(rings);
+  return num_removed;
+}
+
+size_t snapRingsToDirection(const Direction_2& dir, double max_angle,
+                            double max_shift, std::vector<Polygon_2>* rings) {
+  const double dir_angle =
+      std::atan2(CGAL::to_double(dir.dy()), CGAL::to_double(dir.dx()));
+  size_t num_snapped = 0;
+  for (size_t r = 0; r < rings->size(); ++r) {
+    const Polygon_2& ring = (*rings)[r];
+    const size_t n = ring.size();
+    std::vector<Point> points(n);
+    for (size_t i = 0; i < n; ++i)
+      points[i] = {CGAL::to_double(ring[i].x()), CGAL::to_double(ring[i].y())};
+
+    // Every edge as a line through a point in a direction.
+    std::vector<Point> line_points(n), line_dirs(n);
+    std::vector<bool> snapped(n, false);
+    for (size_t i = 0; i < n; ++i) {
+      const Point& a = points[i];
+      const Point& b = points[(i + 1) % n];
+      const double angle = std::atan2(b.y - a.y, b.x - a.x);
+      double offset = angle - dir_angle;
+      offset -= std::round(offset / M_PI_2) * M_PI_2;
+      snapped[i] = std::abs(offset) <= max_angle;
+      const double line_angle = snapped[i] ? angle - offset : angle;
+      line_points[i] = {0.5 * (a.x + b.x), 0.5 * (a.y + b.y)};
+      line_dirs[i] = {std::cos(line_angle), std::sin(line_angle)};
+    }
+
+    // Vertices move to the intersections of their edge lines.
+    Polygon_2 snapped_ring;
+    bool valid = true;
+    for (size_t i = 0; i < n && valid; ++i) {
+      const size_t e = (i + n - 1) % n;
+      Point p = points[i];
+      const Point& u = line_dirs[e];
+      const Point& w = line_dirs[i];
+      const double det = u.x * w.y - u.y * w.x;
+      if ((snapped[e] || snapped[i]) && std::abs(det) > 1e-3) {
+        const double dx = line_points[i].x - line_points[e].x;
+        const double dy = line_points[i].y - line_points[e].y;
+        const double t = (dx * w.y - dy * w.x) / det;
+        p = {line_points[e].x + t * u.x, line_points[e].y + t * u.y};
+        valid = std::hypot(p.x - points[i].x, p.y - points[i].y) <= max_shift;
+      }
+      snapped_ring.push_back(Point_2(p.x, p.y));
+    }
+    if (!valid || !snapped_ring.is_simple() ||
+        snapped_ring.orientation() != ring.orientation())
+      continue;
+    for (size_t o = 0; o < rings->size() && valid; ++o)
+      valid = o == r || !edgesIntersect(snapped_ring, (*rings)[o]);
+    if (!valid) continue;
+
+    (*rings)[r] = snapped_ring;
+    ++num_snapped;
+  }
+  return num_snapped;
+}
+
+}  // namespace polygon_coverage_planning
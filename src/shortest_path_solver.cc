@@ -0,0 +1,56 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shortest_path_solver.h"
+#include "cgal_comm.h"
+#include "funnel.h"
+#include "navigation_mesh.h"
+#include "visibility_graph.h"
+
+namespace polygon_coverage_planning {
+
+bool StraightLineSolver::solve(const Point_2& start, const Point_2& goal,
+                               std::vector<Point_2>* waypoints) const {
+  waypoints->clear();
+  waypoints->push_back(pointInPolygon(polygon_, start)
+                           ? start
+                           : projectPointOnHull(polygon_, start));
+  waypoints->push_back(pointInPolygon(polygon_, goal)
+                           ? goal
+                           : projectPointOnHull(polygon_, goal));
+  return true;
+}
+
+std::unique_ptr<ShortestPathSolver> createShortestPathSolver(
+    const PolygonWithHoles& polygon, ShortestPathEngine engine) {
+  if (polygon.has_holes() && engine == ShortestPathEngine::kNavigationMesh)
+    return std::unique_ptr<ShortestPathSolver>(
+        new navigation_mesh::NavigationMesh(polygon));
+  else if (polygon.has_holes())
+    return std::unique_ptr<ShortestPathSolver>(
+        new visibility_graph::VisibilityGraph(polygon));
+  else if (polygon.outer_boundary().is_convex())
+    return std::unique_ptr<ShortestPathSolver>(
+        new StraightLineSolver(polygon.outer_boundary()));
+  else
+    return std::unique_ptr<ShortestPathSolver>(
+        new FunnelSolver(polygon.outer_boundary()));
+}
+
+}  // namespace polygon_coverage_planning
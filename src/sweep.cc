@@ -17,6 +17,7 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "parallel.h"
 #include "sweep.h"
 #include "visibility_polygon.h"
 #include "weakly_monotone.h"
@@ -24,7 +25,7 @@
 namespace polygon_coverage_planning {
 
 bool computeSweep(const Polygon_2 &in,
-                  const visibility_graph::VisibilityGraph &visibility_graph,
+                  const ShortestPathSolver &shortest_path_solver,
                   const FT offset, const Direction_2 &dir,
                   bool counter_clockwise, std::vector<Point_2> *waypoints) {
   waypoints->clear();
@@ -49,8 +50,11 @@ bool computeSweep(const Polygon_2 &in,
                   std::sqrt(CGAL::to_double(offset_vector.squared_length()));
   const CGAL::Aff_transformation_2<K> kOffset(CGAL::TRANSLATION, offset_vector);
 
+  SweepSegmentGenerator sweep_generator(in, dir);
   Segment_2 sweep_segment;
-  bool has_sweep_segment = findSweepSegment(in, sweep, &sweep_segment);
+  bool has_sweep_segment = sweep_generator.getSweepSegment(sweep, &sweep_segment);
+  // Vertices below this one were below a previous sweep.
+  std::vector<Point_2>::const_iterator first_unchecked_point = sorted_pts.begin();
 
   // Perform the sweep process
   while (has_sweep_segment) {
@@ -61,8 +65,12 @@ bool computeSweep(const Polygon_2 &in,
 
     // Connect previous sweep
     if (!waypoints->empty()) {
+      // Monotone cells connect sweeps along the boundary.
       std::vector<Point_2> shortest_path;
-      if (!calculateShortestPath(visibility_graph, waypoints->back(),
+      if (!sweep_generator.findChainPath(waypoints->back(),
+                                         sweep_segment.source(),
+                                         &shortest_path) &&
+          !calculateShortestPath(shortest_path_solver, waypoints->back(),
                                  sweep_segment.source(), &shortest_path)) {
         return false;
       }
@@ -81,7 +89,7 @@ bool computeSweep(const Polygon_2 &in,
     // Offset the sweep for the next iteration
     sweep = sweep.transform(kOffset);
     Segment_2 prev_sweep_segment = counter_clockwise ? sweep_segment.opposite() : sweep_segment;
-    has_sweep_segment = findSweepSegment(in, sweep, &sweep_segment);
+    has_sweep_segment = sweep_generator.getSweepSegment(sweep, &sweep_segment);
 
     // Handle the final sweep case
     if (!has_sweep_segment && !((!waypoints->empty() &&
@@ -89,7 +97,7 @@ bool computeSweep(const Polygon_2 &in,
           (waypoints->size() > 1 &&
            *std::prev(waypoints->end(), 2) == sorted_pts.back()))) {
       sweep = Line_2(sorted_pts.back(), dir);  // Use the custom direction for the final sweep
-      has_sweep_segment = findSweepSegment(in, sweep, &sweep_segment);
+      has_sweep_segment = sweep_generator.getSweepSegment(sweep, &sweep_segment);
 
       if (!has_sweep_segment) {
         std::cerr << "Failed to calculate final sweep." << std::endl;
@@ -103,11 +111,13 @@ bool computeSweep(const Polygon_2 &in,
     // Check for unobservable points between sweeps
     if (has_sweep_segment) {
       std::vector<Point_2>::const_iterator unobservable_point = sorted_pts.end();
-      checkObservability(prev_sweep_segment, sweep_segment, sorted_pts, kSqOffset, &unobservable_point);
+      checkObservability(prev_sweep_segment, sweep_segment, sorted_pts,
+                         kSqOffset, &first_unchecked_point,
+                         &unobservable_point);
 
       if (unobservable_point != sorted_pts.end()) {
         sweep = Line_2(*unobservable_point, dir);  // Use custom direction here
-        has_sweep_segment = findSweepSegment(in, sweep, &sweep_segment);
+        has_sweep_segment = sweep_generator.getSweepSegment(sweep, &sweep_segment);
 
         if (!has_sweep_segment) {
           std::cerr << "Failed to calculate extra sweep at point: "
@@ -124,6 +134,35 @@ bool computeSweep(const Polygon_2 &in,
   return true;
 }
 
+bool computeSweep(const Polygon_2 &in, const FT offset, const Direction_2 &dir,
+                  bool counter_clockwise, SweepCache *sweep_cache,
+                  std::vector<Point_2> *waypoints) {
+  CanonicalShape<K> shape(in);
+  CachedSweep cached_sweep;
+  if (sweep_cache->find(shape, &cached_sweep) && cached_sweep.dir == dir &&
+      cached_sweep.counter_clockwise == counter_clockwise) {
+    waypoints->clear();
+    waypoints->reserve(cached_sweep.waypoints.size());
+    for (const Vector_2 &v : cached_sweep.waypoints)
+      waypoints->push_back(CGAL::ORIGIN + shape.getOrigin() + v);
+    return true;
+  }
+
+  std::unique_ptr<ShortestPathSolver> shortest_path_solver =
+      createShortestPathSolver(in);
+  if (!computeSweep(in, *shortest_path_solver, offset, dir, counter_clockwise,
+                    waypoints))
+    return false;
+
+  cached_sweep.dir = dir;
+  cached_sweep.counter_clockwise = counter_clockwise;
+  cached_sweep.waypoints.clear();
+  for (const Point_2 &p : *waypoints)
+    cached_sweep.waypoints.push_back(p - (CGAL::ORIGIN + shape.getOrigin()));
+  sweep_cache->insert(shape, cached_sweep);
+  return true;
+}
+
 bool findSweepSegment(const Polygon_2 &p, const Line_2 &l,
                       Segment_2 *sweep_segment) {
   std::vector<Point_2> intersections = findIntersections(p, l);
@@ -133,14 +172,203 @@ bool findSweepSegment(const Polygon_2 &p, const Line_2 &l,
   return true;
 }
 
+SweepSegmentGenerator::SweepSegmentGenerator(const Polygon_2 &polygon,
+                                             const Direction_2 &dir)
+    : polygon_(polygon), x_axis_(Point_2(CGAL::ORIGIN), dir), left_id_(0),
+      right_id_(0) {
+  is_monotone_ = isWeaklyMonotone(polygon, x_axis_);
+  if (!is_monotone_)
+    return;
+
+  const VertexConstCirculator south = findSouth(polygon, x_axis_);
+  const VertexConstCirculator north = findNorth(polygon, x_axis_);
+  VertexConstCirculator vc = south;
+  left_chain_.push_back(*vc);
+  while (vc != north)
+    left_chain_.push_back(*(++vc));
+  vc = south;
+  right_chain_.push_back(*vc);
+  while (vc != north)
+    right_chain_.push_back(*(--vc));
+}
+
+bool SweepSegmentGenerator::getSweepSegment(const Line_2 &l,
+                                            Segment_2 *sweep_segment) {
+  if (!is_monotone_)
+    return findSweepSegment(polygon_, l, sweep_segment);
+
+  std::vector<Point_2> intersections;
+  intersectChain(l, left_chain_, &left_id_, &intersections);
+  intersectChain(l, right_chain_, &right_id_, &intersections);
+  if (intersections.empty())
+    return false;
+
+  // Order as findIntersections does.
+  Line_2 perp_l = l.perpendicular(l.point(0));
+  auto less = [&perp_l](const Point_2 &a, const Point_2 &b) -> bool {
+    return CGAL::has_smaller_signed_distance_to_line(perp_l, a, b);
+  };
+  *sweep_segment =
+      Segment_2(*std::min_element(intersections.begin(), intersections.end(),
+                                  less),
+                *std::max_element(intersections.begin(), intersections.end(),
+                                  less));
+  return true;
+}
+
+void SweepSegmentGenerator::intersectChain(
+    const Line_2 &l, const std::vector<Point_2> &chain, size_t *id,
+    std::vector<Point_2> *intersections) const {
+  auto above = [&l](const Point_2 &p) -> bool {
+    return l.has_on_positive_side(p);
+  };
+  // The line passes below the chain.
+  if (above(chain.front())) {
+    *id = 0;
+    return;
+  }
+
+  while (*id + 1 < chain.size() && !above(chain[*id + 1]))
+    ++(*id);
+  while (*id > 0 && above(chain[*id]))
+    --(*id);
+
+  if (l.has_on(chain[*id])) {
+    // The line touches a vertex or runs along edges.
+    for (size_t i = *id + 1; i-- > 0 && l.has_on(chain[i]);)
+      intersections->push_back(chain[i]);
+  } else if (*id + 1 < chain.size()) {
+    typedef CGAL::cpp11::result_of<Intersect_2(Segment_2, Line_2)>::type
+        Intersection;
+    Intersection result =
+        CGAL::intersection(Segment_2(chain[*id], chain[*id + 1]), l);
+    if (result) {
+      if (const Point_2 *p = boost::get<Point_2>(&*result))
+        intersections->push_back(*p);
+    }
+  }
+}
+
+bool SweepSegmentGenerator::findChainPath(const Point_2 &start,
+                                          const Point_2 &goal,
+                                          std::vector<Point_2> *path) const {
+  if (!is_monotone_)
+    return false;
+
+  // South and north lie on both chains.
+  for (int side = 0; side < 2; ++side) {
+    const std::vector<Point_2> &chain = side == 0 ? left_chain_ : right_chain_;
+    const std::vector<Point_2> &other = side == 0 ? right_chain_ : left_chain_;
+    size_t start_id, goal_id;
+    if (!locateOnChain(chain, start, &start_id) ||
+        !locateOnChain(chain, goal, &goal_id))
+      continue;
+
+    // Walk the chain from start to goal.
+    const bool up = start_id <= goal_id;
+    std::vector<Point_2> walk(1, start);
+    if (up) {
+      for (size_t i = start_id + 1; i <= goal_id; ++i)
+        walk.push_back(chain[i]);
+    } else {
+      for (size_t i = start_id; i > goal_id; --i)
+        walk.push_back(chain[i]);
+    }
+    walk.push_back(goal);
+
+    // Pull the walk taut. The left chain is traversed counter-clockwise
+    // upwards, i.e., with the interior on the left, and the string only bends
+    // around reflex vertices.
+    const CGAL::Orientation bend =
+        (side == 0) == up ? CGAL::RIGHT_TURN : CGAL::LEFT_TURN;
+    path->assign(1, start);
+    for (size_t i = 1; i < walk.size(); ++i) {
+      if (i + 1 < walk.size() &&
+          (walk[i] == path->back() || walk[i] == goal))
+        continue;
+      while (path->size() > 1 &&
+             CGAL::orientation((*path)[path->size() - 2], path->back(),
+                               walk[i]) != bend)
+        path->pop_back();
+      path->push_back(walk[i]);
+    }
+
+    // The string must not cut through the other chain.
+    const Point_2 &low = up ? start : goal;
+    const Point_2 &high = up ? goal : start;
+    size_t i = lowerBound(other, low);
+    i = i > 0 ? i - 1 : 0;
+    bool is_free = true;
+    for (; is_free && i + 1 < other.size() &&
+           !CGAL::has_larger_signed_distance_to_line(x_axis_, other[i], high);
+         ++i) {
+      const Segment_2 edge(other[i], other[i + 1]);
+      for (size_t j = 0; is_free && j + 1 < path->size(); ++j) {
+        typedef CGAL::cpp11::result_of<Intersect_2(Segment_2, Segment_2)>::type
+            Intersection;
+        Intersection result =
+            CGAL::intersection(Segment_2((*path)[j], (*path)[j + 1]), edge);
+        if (!result)
+          continue;
+        const Point_2 *p = boost::get<Point_2>(&*result);
+        is_free = p && (*p == start || *p == goal);
+      }
+    }
+    if (is_free)
+      return true;
+  }
+
+  return false;
+}
+
+bool SweepSegmentGenerator::locateOnChain(const std::vector<Point_2> &chain,
+                                          const Point_2 &p, size_t *id) const {
+  size_t i = lowerBound(chain, p);
+  i = i > 0 ? i - 1 : 0;
+  for (; i + 1 < chain.size() &&
+         !CGAL::has_larger_signed_distance_to_line(x_axis_, chain[i], p);
+       ++i) {
+    if (Segment_2(chain[i], chain[i + 1]).has_on(p)) {
+      *id = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t SweepSegmentGenerator::lowerBound(const std::vector<Point_2> &chain,
+                                         const Point_2 &p) const {
+  return std::lower_bound(chain.begin(), chain.end(), p,
+                          [this](const Point_2 &a, const Point_2 &b) -> bool {
+                            return CGAL::has_smaller_signed_distance_to_line(
+                                x_axis_, a, b);
+                          }) -
+         chain.begin();
+}
+
+void checkObservability(
+    const Segment_2 &prev_sweep, const Segment_2 &sweep,
+    const std::vector<Point_2> &sorted_pts, const FT max_sq_distance,
+    std::vector<Point_2>::const_iterator *lowest_unobservable_point) {
+  std::vector<Point_2>::const_iterator first_point = sorted_pts.begin();
+  checkObservability(prev_sweep, sweep, sorted_pts, max_sq_distance,
+                     &first_point, lowest_unobservable_point);
+}
+
 void checkObservability(
     const Segment_2 &prev_sweep, const Segment_2 &sweep,
     const std::vector<Point_2> &sorted_pts, const FT max_sq_distance,
+    std::vector<Point_2>::const_iterator *first_point,
     std::vector<Point_2>::const_iterator *lowest_unobservable_point) {
   *lowest_unobservable_point = sorted_pts.end();
 
+  // Skip the points below prev_sweep once.
+  while (*first_point != sorted_pts.end() &&
+         prev_sweep.supporting_line().has_on_positive_side(**first_point))
+    ++(*first_point);
+
   // Find first point that is between prev_sweep and sweep and unobservable.
-  for (std::vector<Point_2>::const_iterator it = sorted_pts.begin();
+  for (std::vector<Point_2>::const_iterator it = *first_point;
        it != sorted_pts.end(); ++it) {
     // 左边/逆时针 = 正； 右边/顺时针 = 负
     if (prev_sweep.supporting_line().has_on_positive_side(*it))
@@ -161,38 +389,57 @@ void checkObservability(
 
 bool computeAllSweeps(const Polygon_2 &poly, const double max_sweep_offset,
                       std::vector<std::vector<Point_2>> *cluster_sweeps) {
-  cluster_sweeps->clear();
-  cluster_sweeps->reserve(2 * poly.size());
+  std::vector<std::vector<std::vector<Point_2>>> all_sweeps;
+  const bool success = computeAllSweeps(std::vector<Polygon_2>(1, poly),
+                                        max_sweep_offset, &all_sweeps);
+  *cluster_sweeps = std::move(all_sweeps.front());
+  return success;
+}
 
-  // Find all sweepable directions.
-  std::vector<Direction_2> dirs = getAllSweepableEdgeDirections(poly);
-
-  // Compute all possible sweeps.
-  visibility_graph::VisibilityGraph vis_graph(poly);
-  for (const Direction_2 &dir : dirs) {
-    bool counter_clockwise = true;
-    std::vector<Point_2> sweep;
-    if (!computeSweep(poly, vis_graph, max_sweep_offset, dir, counter_clockwise,
-                      &sweep)) {
-      std::cout << "Cannot compute counter-clockwise sweep." << std::endl;
-      return false;
-    } else {
-      cluster_sweeps->push_back(sweep);
-      std::reverse(sweep.begin(), sweep.end());
-      cluster_sweeps->push_back(sweep);
-    }
+bool computeAllSweeps(
+    const std::vector<Polygon_2> &polys, const double max_sweep_offset,
+    std::vector<std::vector<std::vector<Point_2>>> *cluster_sweeps) {
+  cluster_sweeps->assign(polys.size(), std::vector<std::vector<Point_2>>());
 
-    if (!computeSweep(poly, vis_graph, max_sweep_offset, dir,
-                      !counter_clockwise, &sweep)) {
-      std::cout << "Cannot compute clockwise sweep." << std::endl;
-      return false;
-    } else {
-      cluster_sweeps->push_back(sweep);
-      std::reverse(sweep.begin(), sweep.end());
-      cluster_sweeps->push_back(sweep);
+  // Find all sweepable directions.
+  std::vector<std::vector<Direction_2>> dirs(polys.size());
+  std::vector<std::unique_ptr<ShortestPathSolver>> shortest_path_solvers(
+      polys.size());
+  parallelFor(polys.size(), [&](size_t i) {
+    dirs[i] = getAllSweepableEdgeDirections(polys[i]);
+    shortest_path_solvers[i] = createShortestPathSolver(polys[i]);
+  });
+
+  // Compute all possible sweeps in one loop over (polygon, sweep) pairs.
+  // Every direction yields a counter-clockwise and a clockwise sweep, each
+  // also in reverse.
+  std::vector<std::pair<size_t, size_t>> jobs;
+  for (size_t i = 0; i < polys.size(); ++i) {
+    (*cluster_sweeps)[i].resize(4 * dirs[i].size());
+    for (size_t j = 0; j < 2 * dirs[i].size(); ++j) jobs.emplace_back(i, j);
+  }
+  std::vector<char> success(jobs.size(), false);
+  parallelFor(jobs.size(), [&](size_t k) {
+    const size_t i = jobs[k].first, j = jobs[k].second;
+    const bool counter_clockwise = j % 2 == 0;
+    std::vector<Point_2> &sweep = (*cluster_sweeps)[i][2 * j];
+    success[k] = computeSweep(polys[i], *shortest_path_solvers[i],
+                              max_sweep_offset, dirs[i][j / 2],
+                              counter_clockwise, &sweep);
+    (*cluster_sweeps)[i][2 * j + 1].assign(sweep.rbegin(), sweep.rend());
+  });
+
+  bool all_success = true;
+  for (size_t k = 0; k < jobs.size(); ++k) {
+    if (!success[k]) {
+      std::cout << "Cannot compute "
+                << (jobs[k].second % 2 == 0 ? "counter-clockwise" : "clockwise")
+                << " sweep." << std::endl;
+      (*cluster_sweeps)[jobs[k].first].clear();
+      all_success = false;
     }
   }
-  return true;
+  return all_success;
 }
 
 bool calculateShortestPath(
@@ -231,6 +478,23 @@ bool calculateShortestPath(
   return true;
 }
 
+bool calculateShortestPath(const ShortestPathSolver &shortest_path_solver,
+                           const Point_2 &start, const Point_2 &goal,
+                           std::vector<Point_2> *shortest_path) {
+  if (!shortest_path_solver.solve(start, goal, shortest_path)) {
+    std::cout << "Cannot compute shortest path from " << start << " to " << goal
+              << std::endl;
+    return false;
+  }
+
+  if (shortest_path->size() < 2) {
+    std::cout << "Shortest path too short." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
 std::vector<Point_2> sortVerticesToLine(const Polygon_2 &p, const Line_2 &l) {
   // Copy points.
   std::vector<Point_2> pts(p.size());
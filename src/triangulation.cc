@@ -0,0 +1,135 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <list>
+
+#include "triangulation.h"
+
+namespace polygon_coverage_planning {
+
+namespace {
+
+void insertConstraints(const Polygon_2& polygon, CDT* cdt) {
+  for (EdgeConstIterator it = polygon.edges_begin(); it != polygon.edges_end();
+       ++it)
+    cdt->insert_constraint(it->source(), it->target());
+}
+
+// Flood fill the faces reachable from start without crossing constraints.
+// https://doc.cgal.org/latest/Triangulation_2/index.html#title30
+void markDomain(CDT* cdt, FaceHandle start, int level,
+                std::list<CDT::Edge>* border) {
+  if (start->info().nesting_level != -1)
+    return;
+  std::list<FaceHandle> queue;
+  queue.push_back(start);
+  while (!queue.empty()) {
+    FaceHandle fh = queue.front();
+    queue.pop_front();
+    if (fh->info().nesting_level != -1)
+      continue;
+    fh->info().nesting_level = level;
+    for (int i = 0; i < 3; ++i) {
+      CDT::Edge e(fh, i);
+      FaceHandle n = fh->neighbor(i);
+      if (n->info().nesting_level == -1) {
+        if (cdt->is_constrained(e))
+          border->push_back(e);
+        else
+          queue.push_back(n);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void triangulatePolygon(const PolygonWithHoles& pwh, CDT* cdt,
+                        std::vector<FaceHandle>* faces) {
+  cdt->clear();
+  faces->clear();
+  insertConstraints(pwh.outer_boundary(), cdt);
+  for (PolygonWithHoles::Hole_const_iterator hit = pwh.holes_begin();
+       hit != pwh.holes_end(); ++hit)
+    insertConstraints(*hit, cdt);
+
+  // Alternate between outside and inside across every constraint.
+  for (CDT::All_faces_iterator it = cdt->all_faces_begin();
+       it != cdt->all_faces_end(); ++it)
+    it->info() = FaceInfo();
+  std::list<CDT::Edge> border;
+  markDomain(cdt, cdt->infinite_face(), 0, &border);
+  while (!border.empty()) {
+    CDT::Edge e = border.front();
+    border.pop_front();
+    FaceHandle n = e.first->neighbor(e.second);
+    if (n->info().nesting_level == -1)
+      markDomain(cdt, n, e.first->info().nesting_level + 1, &border);
+  }
+
+  for (CDT::Finite_faces_iterator it = cdt->finite_faces_begin();
+       it != cdt->finite_faces_end(); ++it) {
+    if (!it->info().inDomain())
+      continue;
+    it->info().id = static_cast<int>(faces->size());
+    faces->push_back(it);
+  }
+}
+
+bool locateFace(const CDT& cdt, const Point_2& p, FaceHandle* face) {
+  CDT::Locate_type type;
+  int li;
+  FaceHandle fh = cdt.locate(p, type, li);
+  switch (type) {
+    case CDT::FACE:
+      break;
+    case CDT::EDGE:
+      if (!fh->info().inDomain())
+        fh = fh->neighbor(li);
+      break;
+    case CDT::VERTEX: {
+      CDT::Face_circulator fc = cdt.incident_faces(fh->vertex(li));
+      CDT::Face_circulator done = fc;
+      do {
+        if (!cdt.is_infinite(fc) && fc->info().inDomain()) {
+          fh = fc;
+          break;
+        }
+      } while (++fc != done);
+      break;
+    }
+    default:
+      return false;
+  }
+  if (cdt.is_infinite(fh) || !fh->info().inDomain())
+    return false;
+  *face = fh;
+  return true;
+}
+
+void getPortal(const FaceHandle& face, const FaceHandle& neighbor,
+               Point_2* left, Point_2* right) {
+  // Faces are counter-clockwise. Seen from the opposite vertex, the edge goes
+  // from right to left.
+  const int i = face->index(neighbor);
+  *right = face->vertex(CDT::ccw(i))->point();
+  *left = face->vertex(CDT::cw(i))->point();
+}
+
+}  // namespace polygon_coverage_planning
@@ -0,0 +1,229 @@
+/*
+ * polygon_coverage_planning implements algorithms for coverage planning in
+ * general polygons with holes. Copyright (C) 2019, Rik Bähnemann, Autonomous
+ * Systems Lab, ETH Zürich
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#include "tsp.h"
+
+namespace polygon_coverage_planning {
+
+namespace {
+
+const double kInfinity = std::numeric_limits<double>::max();
+
+// Held-Karp dynamic program over subsets. O(2^n n^2).
+void solveHeldKarp(const CostMatrix& cost, int start, int end,
+                   std::vector<size_t>* path) {
+  const size_t n = cost.size();
+  const size_t num_subsets = static_cast<size_t>(1) << n;
+  // dp[subset * n + j]: cheapest path through subset that ends in j.
+  std::vector<double> dp(num_subsets * n, kInfinity);
+  std::vector<int> parent(num_subsets * n, -1);
+  for (size_t j = 0; j < n; ++j) {
+    if (start == -1 || static_cast<size_t>(start) == j)
+      dp[(static_cast<size_t>(1) << j) * n + j] = 0.0;
+  }
+
+  for (size_t subset = 1; subset < num_subsets; ++subset) {
+    for (size_t j = 0; j < n; ++j) {
+      const double current = dp[subset * n + j];
+      if (current == kInfinity) continue;
+      for (size_t k = 0; k < n; ++k) {
+        if (subset & (static_cast<size_t>(1) << k)) continue;
+        const size_t next = subset | (static_cast<size_t>(1) << k);
+        const double candidate = current + cost[j][k];
+        if (candidate < dp[next * n + k]) {
+          dp[next * n + k] = candidate;
+          parent[next * n + k] = static_cast<int>(j);
+        }
+      }
+    }
+  }
+
+  const size_t full = num_subsets - 1;
+  int last = end;
+  if (last == -1) {
+    for (size_t j = 0; j < n; ++j) {
+      if (last == -1 || dp[full * n + j] < dp[full * n + last])
+        last = static_cast<int>(j);
+    }
+  }
+
+  path->clear();
+  size_t subset = full;
+  for (int j = last; j != -1;) {
+    path->push_back(static_cast<size_t>(j));
+    const int prev = parent[subset * n + j];
+    subset &= ~(static_cast<size_t>(1) << j);
+    j = prev;
+  }
+  std::reverse(path->begin(), path->end());
+}
+
+void solveNearestNeighbor(const CostMatrix& cost, int start, int end,
+                          std::vector<size_t>* path) {
+  const size_t n = cost.size();
+  std::vector<bool> visited(n, false);
+  path->clear();
+  size_t current = start == -1 ? 0 : static_cast<size_t>(start);
+  // Keep the fixed end for last.
+  if (end != -1) visited[end] = true;
+  if (start == -1 && end == 0 && n > 1) current = 1;
+  visited[current] = true;
+  path->push_back(current);
+  while (path->size() + (end == -1 ? 0 : 1) < n) {
+    size_t best = n;
+    for (size_t k = 0; k < n; ++k) {
+      if (!visited[k] && (best == n || cost[current][k] < cost[current][best]))
+        best = k;
+    }
+    visited[best] = true;
+    path->push_back(best);
+    current = best;
+  }
+  if (end != -1 && (path->empty() || path->back() != static_cast<size_t>(end)))
+    path->push_back(static_cast<size_t>(end));
+}
+
+// Cost between path positions, 0 beyond the path ends.
+inline double linkCost(const CostMatrix& cost, const std::vector<size_t>& path,
+                       int i, int j) {
+  if (i < 0 || j < 0 || i >= static_cast<int>(path.size()) ||
+      j >= static_cast<int>(path.size()))
+    return 0.0;
+  return cost[path[i]][path[j]];
+}
+
+// Reverse path[i..j] if that shortens the path.
+bool improveTwoOpt(const CostMatrix& cost, int first, int last,
+                   std::vector<size_t>* path) {
+  bool improved = false;
+  for (int i = first; i < last; ++i) {
+    for (int j = i + 1; j <= last; ++j) {
+      const double delta = linkCost(cost, *path, i - 1, j) +
+                           linkCost(cost, *path, i, j + 1) -
+                           linkCost(cost, *path, i - 1, i) -
+                           linkCost(cost, *path, j, j + 1);
+      if (delta < -1e-9) {
+        std::reverse(path->begin() + i, path->begin() + j + 1);
+        improved = true;
+      }
+    }
+  }
+  return improved;
+}
+
+// Move a segment of up to three nodes to a better place, possibly reversed.
+bool improveOrOpt(const CostMatrix& cost, int first, int last,
+                  std::vector<size_t>* path) {
+  bool improved = false;
+  for (int length = 1; length <= 3; ++length) {
+    for (int i = first; i + length - 1 <= last; ++i) {
+      const int j = i + length - 1;
+      const double removal = linkCost(cost, *path, i - 1, i) +
+                             linkCost(cost, *path, j, j + 1) -
+                             linkCost(cost, *path, i - 1, j + 1);
+      std::vector<size_t> segment(path->begin() + i, path->begin() + j + 1);
+      std::vector<size_t> rest(path->begin(), path->begin() + i);
+      rest.insert(rest.end(), path->begin() + j + 1, path->end());
+
+      // Insert between rest[k - 1] and rest[k].
+      const int rest_size = static_cast<int>(rest.size());
+      const int k_min = first;
+      const int k_max = last - length + 1;
+      double best_delta = -1e-9;
+      int best_k = -1;
+      bool best_reversed = false;
+      for (int k = k_min; k <= k_max; ++k) {
+        if (k == i) continue;
+        const bool has_prev = k > 0, has_next = k < rest_size;
+        const double old_link =
+            has_prev && has_next ? cost[rest[k - 1]][rest[k]] : 0.0;
+        for (int reversed = 0; reversed < 2; ++reversed) {
+          const size_t head = reversed ? segment.back() : segment.front();
+          const size_t tail = reversed ? segment.front() : segment.back();
+          const double insertion = (has_prev ? cost[rest[k - 1]][head] : 0.0) +
+                                   (has_next ? cost[tail][rest[k]] : 0.0) -
+                                   old_link;
+          const double delta = insertion - removal;
+          if (delta < best_delta) {
+            best_delta = delta;
+            best_k = k;
+            best_reversed = reversed;
+          }
+        }
+      }
+
+      if (best_k != -1) {
+        if (best_reversed) std::reverse(segment.begin(), segment.end());
+        rest.insert(rest.begin() + best_k, segment.begin(), segment.end());
+        *path = rest;
+        improved = true;
+      }
+    }
+  }
+  return improved;
+}
+
+}  // namespace
+
+bool solveTsp(const CostMatrix& cost, int start, int end, double time_budget,
+              std::vector<size_t>* path) {
+  path->clear();
+  const int n = static_cast<int>(cost.size());
+  if (n == 0) return true;
+  if (start >= n || end >= n || (start != -1 && start == end && n > 1)) {
+    std::cout << "Invalid TSP start or end." << std::endl;
+    return false;
+  }
+
+  if (cost.size() <= kMaxExactTspSize) {
+    solveHeldKarp(cost, start, end, path);
+    return true;
+  }
+
+  const auto deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(time_budget));
+  solveNearestNeighbor(cost, start, end, path);
+
+  // Fixed ends are never moved.
+  const int first = start == -1 ? 0 : 1;
+  const int last = end == -1 ? n - 1 : n - 2;
+  bool improved = true;
+  while (improved && std::chrono::steady_clock::now() < deadline) {
+    improved = improveTwoOpt(cost, first, last, path);
+    if (std::chrono::steady_clock::now() >= deadline) break;
+    improved = improveOrOpt(cost, first, last, path) || improved;
+  }
+  return true;
+}
+
+double computePathCost(const CostMatrix& cost,
+                       const std::vector<size_t>& path) {
+  double sum = 0.0;
+  for (size_t i = 1; i < path.size(); ++i) sum += cost[path[i - 1]][path[i]];
+  return sum;
+}
+
+}  // namespace polygon_coverage_planning
@@ -19,9 +19,97 @@
 
 #include "weakly_monotone.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
 namespace polygon_coverage_planning {
 
-bool isWeaklyMonotone(const Polygon_2& in, const Line_2& x_axis) {
+namespace {
+
+// Maps v to the half plane of directions in [0, 180) degrees.
+template <class Kernel>
+CGAL::Vector_2<Kernel> toUpperHalfPlane(const CGAL::Vector_2<Kernel>& v) {
+  return (v.y() < 0 || (v.y() == 0 && v.x() < 0)) ? -v : v;
+}
+
+// Adds one to all direction classes strictly between 'from' and 'to', walking
+// counter-clockwise and wrapping around at 180 degrees.
+void addOpenInterval(size_t from, size_t to, std::vector<int>* diff) {
+  const size_t num_classes = diff->size() - 1;
+  if (from < to) {
+    (*diff)[from + 1]++;
+    (*diff)[to]--;
+  } else {
+    (*diff)[from + 1]++;
+    (*diff)[num_classes]--;
+    (*diff)[0]++;
+    (*diff)[to]--;
+  }
+}
+
+// Convex hull of the polygon vertices as ccw vertex indices. In contrast to
+// CGAL::convex_hull_2 vertices on hull edges are kept, so that every extreme
+// vertex of the polygon can be found on the hull.
+template <class Kernel>
+std::vector<size_t> convexHullWithCollinear(
+    const std::vector<CGAL::Point_2<Kernel>>& pts) {
+  std::vector<size_t> sorted(pts.size());
+  std::iota(sorted.begin(), sorted.end(), 0);
+  std::sort(sorted.begin(), sorted.end(), [&pts](size_t a, size_t b) {
+    return CGAL::compare_xy(pts[a], pts[b]) == CGAL::SMALLER;
+  });
+
+  std::vector<size_t> hull;
+  auto add_chain = [&pts, &hull](size_t i, size_t chain_start) {
+    while (hull.size() >= chain_start + 2 &&
+           CGAL::orientation(pts[hull[hull.size() - 2]], pts[hull.back()],
+                             pts[i]) == CGAL::RIGHT_TURN)
+      hull.pop_back();
+    hull.push_back(i);
+  };
+  // Lower chain.
+  for (size_t i : sorted) add_chain(i, 0);
+  hull.pop_back();
+  // Upper chain.
+  const size_t upper_start = hull.size();
+  for (auto it = sorted.rbegin(); it != sorted.rend(); ++it)
+    add_chain(*it, upper_start);
+  hull.pop_back();
+  return hull;
+}
+
+template <class Kernel>
+std::vector<CGAL::Direction_2<Kernel>> getAllSweepableEdgeDirectionsNaive(
+    const CGAL::Polygon_2<Kernel>& in) {
+  typedef CGAL::Direction_2<Kernel> Direction_2;
+  typedef typename CGAL::Polygon_2<Kernel>::Edge_const_iterator
+      EdgeConstIterator;
+  // Get all directions.
+  std::vector<Direction_2> dirs;
+  for (EdgeConstIterator it = in.edges_begin(); it != in.edges_end(); ++it) {
+    // Check if this edge direction is already in the set.
+    typename std::vector<Direction_2>::iterator last =
+        std::find_if(dirs.begin(), dirs.end(), [&it](const Direction_2& dir) {
+          return CGAL::orientation(dir.vector(), it->to_vector()) ==
+                 CGAL::COLLINEAR;
+        });
+    if (last != dirs.end()) continue;
+    // Check if the polygon is monotone perpendicular to this edge direction.
+    if (isWeaklyMonotone(in, it->supporting_line()))
+      dirs.push_back(it->direction());
+  }
+
+  return dirs;
+}
+
+}  // namespace
+
+template <class Kernel>
+bool isWeaklyMonotone(const CGAL::Polygon_2<Kernel>& in,
+                      const CGAL::Line_2<Kernel>& x_axis) {
+  typedef typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator
+      VertexConstCirculator;
   // Find north and south.
   VertexConstCirculator north = findNorth(in, x_axis);
   VertexConstCirculator south = findSouth(in, x_axis);
@@ -47,26 +135,199 @@ bool isWeaklyMonotone(const Polygon_2& in, const Line_2& x_axis) {
   return true;
 }
 
-std::vector<Direction_2> getAllSweepableEdgeDirections(const Polygon_2& in) {
-  // Get all directions.
-  std::vector<Direction_2> dirs;
-  for (EdgeConstIterator it = in.edges_begin(); it != in.edges_end(); ++it) {
-    // Check if this edge direction is already in the set.
-    std::vector<Direction_2>::iterator last =
-        std::find_if(dirs.begin(), dirs.end(), [&it](const Direction_2& dir) {
-          return CGAL::orientation(dir.vector(), it->to_vector()) ==
-                 CGAL::COLLINEAR;
-        });
-    if (last != dirs.end()) continue;
-    // Check if the polygon is monotone perpendicular to this edge direction.
-    if (isWeaklyMonotone(in, it->supporting_line()))
-      dirs.push_back(it->direction());
+template <class Kernel>
+std::vector<CGAL::Direction_2<Kernel>> getAllSweepableEdgeDirections(
+    const CGAL::Polygon_2<Kernel>& in) {
+  std::vector<CGAL::Direction_2<Kernel>> dirs;
+  getAllSweepableEdgeDirections(in, &dirs, nullptr);
+  return dirs;
+}
+
+template <class Kernel>
+void getAllSweepableEdgeDirections(
+    const CGAL::Polygon_2<Kernel>& in,
+    std::vector<CGAL::Direction_2<Kernel>>* dirs,
+    std::vector<double>* altitudes) {
+  typedef CGAL::Point_2<Kernel> Point_2;
+  typedef CGAL::Vector_2<Kernel> Vector_2;
+  typedef CGAL::Direction_2<Kernel> Direction_2;
+  typedef CGAL::Line_2<Kernel> Line_2;
+  dirs->clear();
+  if (altitudes) altitudes->clear();
+
+  const size_t n = in.size();
+  std::vector<Point_2> pts(in.vertices_begin(), in.vertices_end());
+  std::vector<Vector_2> edges(n);
+  bool degenerate = n < 3;
+  for (size_t i = 0; i < n && !degenerate; ++i) {
+    edges[i] = pts[(i + 1) % n] - pts[i];
+    degenerate = edges[i] == CGAL::NULL_VECTOR;
+  }
+  std::vector<size_t> hull;
+  if (!degenerate) {
+    hull = convexHullWithCollinear(pts);
+    degenerate = hull.size() < 3;
+  }
+  if (degenerate) {
+    // Fall back to testing every edge direction on its own.
+    *dirs = getAllSweepableEdgeDirectionsNaive(in);
+    if (altitudes) {
+      for (const Direction_2& dir : *dirs) {
+        Line_2 x_axis(Point_2(CGAL::ORIGIN), dir);
+        altitudes->push_back(computeAltitude(*findSouth(in, x_axis),
+                                             *findNorth(in, x_axis), dir));
+      }
+    }
+    return;
   }
 
-  return dirs;
+  // Sort the edges by direction modulo 180 degrees and group parallel edges
+  // into direction classes.
+  std::vector<Vector_2> upper(n);
+  for (size_t i = 0; i < n; ++i) upper[i] = toUpperHalfPlane(edges[i]);
+  std::vector<size_t> by_angle(n);
+  std::iota(by_angle.begin(), by_angle.end(), 0);
+  std::sort(by_angle.begin(), by_angle.end(), [&upper](size_t a, size_t b) {
+    return CGAL::orientation(upper[a], upper[b]) == CGAL::LEFT_TURN;
+  });
+  std::vector<size_t> edge_class(n);
+  std::vector<size_t> class_edge;  // Representative edge of each class.
+  for (size_t i = 0; i < n; ++i) {
+    if (i == 0 || CGAL::orientation(upper[class_edge.back()],
+                                     upper[by_angle[i]]) != CGAL::COLLINEAR)
+      class_edge.push_back(by_angle[i]);
+    edge_class[by_angle[i]] = class_edge.size() - 1;
+  }
+  const size_t num_classes = class_edge.size();
+
+  // The polygon is weakly monotone perpendicular to a direction iff the
+  // cyclic sequence of edge signs, ignoring edges parallel to the direction,
+  // changes sign at most twice. A vertex contributes a sign change for all
+  // directions strictly inside the angle its edges turn by.
+  std::vector<int> diff(num_classes + 1, 0);
+  for (size_t i = 0; i < n; ++i) {
+    const Vector_2& e_in = edges[(i + n - 1) % n];
+    const Vector_2& e_out = edges[i];
+    const size_t c_in = edge_class[(i + n - 1) % n];
+    const size_t c_out = edge_class[i];
+    switch (CGAL::orientation(e_in, e_out)) {
+      case CGAL::LEFT_TURN:
+        addOpenInterval(c_in, c_out, &diff);
+        break;
+      case CGAL::RIGHT_TURN:
+        addOpenInterval(c_out, c_in, &diff);
+        break;
+      default:
+        // Spike: sign changes for every direction but its own.
+        if (e_in * e_out < 0) addOpenInterval(c_in, c_in, &diff);
+        break;
+    }
+  }
+  std::vector<int> sign_changes(num_classes);
+  std::partial_sum(diff.begin(), diff.end() - 1, sign_changes.begin());
+
+  // Runs of edges parallel to a direction change sign if the edges before and
+  // after the run point to different sides.
+  for (size_t i = 0; i < n; ++i) {
+    const size_t c = edge_class[i];
+    if (edge_class[(i + n - 1) % n] == c) continue;
+    size_t j = i;
+    while (edge_class[j] == c) j = (j + 1) % n;
+    const Vector_2& d = upper[class_edge[c]];
+    if (CGAL::orientation(d, edges[(i + n - 1) % n]) !=
+        CGAL::orientation(d, edges[j]))
+      sign_changes[c]++;
+  }
+
+  // Rotating calipers: the lowest and highest hull vertex perpendicular to
+  // the class directions move counter-clockwise along the hull as the
+  // direction increases.
+  std::vector<size_t> lowest(num_classes), highest(num_classes);
+  if (altitudes) {
+    const size_t h = hull.size();
+    auto edge_sign = [&pts, &hull, h](size_t t, const Vector_2& normal) {
+      return CGAL::sign((pts[hull[(t + 1) % h]] - pts[hull[t]]) * normal);
+    };
+    // Among the extreme hull vertices starting at t choose the one with the
+    // smallest polygon index, as findSouth does.
+    auto first_extreme = [&hull, &edge_sign, h](size_t t,
+                                                const Vector_2& normal) {
+      size_t best = hull[t];
+      for (size_t k = 0; k + 1 < h && edge_sign(t, normal) == CGAL::ZERO;
+           ++k) {
+        t = (t + 1) % h;
+        best = std::min(best, hull[t]);
+      }
+      return best;
+    };
+    // Start of the run of hull vertices maximizing the projection on normal.
+    auto find_max = [&pts, &hull, &edge_sign, h](const Vector_2& normal) {
+      size_t t = 0;
+      for (size_t k = 1; k < h; ++k)
+        if ((pts[hull[k]] - CGAL::ORIGIN) * normal >
+            (pts[hull[t]] - CGAL::ORIGIN) * normal)
+          t = k;
+      for (size_t k = 0;
+           k + 1 < h && edge_sign((t + h - 1) % h, normal) == CGAL::ZERO; ++k)
+        t = (t + h - 1) % h;
+      return t;
+    };
+
+    size_t t_max = 0, t_min = 0;
+    for (size_t c = 0; c < num_classes; ++c) {
+      const Vector_2 normal =
+          upper[class_edge[c]].perpendicular(CGAL::POSITIVE);
+      if (c == 0) {
+        t_max = find_max(normal);
+        t_min = find_max(-normal);
+      } else {
+        for (size_t k = 0; k < h && edge_sign(t_max, normal) == CGAL::POSITIVE;
+             ++k)
+          t_max = (t_max + 1) % h;
+        for (size_t k = 0;
+             k < h && edge_sign(t_min, -normal) == CGAL::POSITIVE; ++k)
+          t_min = (t_min + 1) % h;
+      }
+      highest[c] = first_extreme(t_max, normal);
+      lowest[c] = first_extreme(t_min, -normal);
+    }
+  }
+
+  // Report the directions in edge order like the edge-by-edge test does.
+  std::vector<bool> reported(num_classes, false);
+  for (size_t i = 0; i < n; ++i) {
+    const size_t c = edge_class[i];
+    if (reported[c]) continue;
+    reported[c] = true;
+    if (sign_changes[c] > 2) continue;
+    const Direction_2 dir = edges[i].direction();
+    dirs->push_back(dir);
+    if (altitudes) {
+      // South has the smallest signed distance to a line along the edge.
+      const bool flipped = upper[i] != edges[i];
+      const Point_2& south = pts[flipped ? highest[c] : lowest[c]];
+      const Point_2& north = pts[flipped ? lowest[c] : highest[c]];
+      altitudes->push_back(computeAltitude(south, north, dir));
+    }
+  }
 }
 
-VertexConstCirculator findSouth(const Polygon_2& in, const Line_2& x_axis) {
+template <class Kernel>
+double computeAltitude(const CGAL::Point_2<Kernel>& south,
+                       const CGAL::Point_2<Kernel>& north,
+                       const CGAL::Direction_2<Kernel>& dir) {
+  typedef CGAL::Line_2<Kernel> Line_2;
+  auto orthogonal_vec = dir.vector().perpendicular(CGAL::Orientation::POSITIVE);
+  Line_2 line_through_n(north, orthogonal_vec.direction());
+  auto s_proj = line_through_n.projection(south);
+  return std::sqrt(CGAL::to_double(CGAL::squared_distance(north, s_proj)));
+}
+
+template <class Kernel>
+typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator findSouth(
+    const CGAL::Polygon_2<Kernel>& in, const CGAL::Line_2<Kernel>& x_axis) {
+  typedef typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator
+      VertexConstCirculator;
   VertexConstCirculator vc = in.vertices_circulator();
   VertexConstCirculator v = vc;
   do {
@@ -75,8 +336,37 @@ VertexConstCirculator findSouth(const Polygon_2& in, const Line_2& x_axis) {
   return v;
 }
 
-VertexConstCirculator findNorth(const Polygon_2& in, const Line_2& x_axis) {
+template <class Kernel>
+typename CGAL::Polygon_2<Kernel>::Vertex_const_circulator findNorth(
+    const CGAL::Polygon_2<Kernel>& in, const CGAL::Line_2<Kernel>& x_axis) {
   return findSouth(in, x_axis.opposite());
 }
 
+// Exact for the final decomposition, inexact to screen sweep directions.
+template bool isWeaklyMonotone(const Polygon_2&, const Line_2&);
+template std::vector<Direction_2> getAllSweepableEdgeDirections(
+    const Polygon_2&);
+template void getAllSweepableEdgeDirections(const Polygon_2&,
+                                            std::vector<Direction_2>*,
+                                            std::vector<double>*);
+template double computeAltitude(const Point_2&, const Point_2&,
+                                const Direction_2&);
+template VertexConstCirculator findSouth(const Polygon_2&, const Line_2&);
+template VertexConstCirculator findNorth(const Polygon_2&, const Line_2&);
+
+template bool isWeaklyMonotone(const InexactPolygon_2&,
+                               const InexactKernel::Line_2&);
+template std::vector<InexactKernel::Direction_2> getAllSweepableEdgeDirections(
+    const InexactPolygon_2&);
+template void getAllSweepableEdgeDirections(
+    const InexactPolygon_2&, std::vector<InexactKernel::Direction_2>*,
+    std::vector<double>*);
+template double computeAltitude(const InexactKernel::Point_2&,
+                                const InexactKernel::Point_2&,
+                                const InexactKernel::Direction_2&);
+template InexactVertexConstCirculator findSouth(const InexactPolygon_2&,
+                                                const InexactKernel::Line_2&);
+template InexactVertexConstCirculator findNorth(const InexactPolygon_2&,
+                                                const InexactKernel::Line_2&);
+
 }  // namespace polygon_coverage_planning